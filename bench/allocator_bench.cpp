@@ -0,0 +1,216 @@
+// Набор бенчмарков аллокатора на Google Benchmark.
+// Контейнеры: std::map, std::list, std::vector, MyContainer.
+// Аллокаторы: std::allocator, std::pmr пулы, allocator<T, N> с разными N и в монотонном режиме,
+// pool_memory_resource под std::pmr::polymorphic_allocator.
+// Каждый прогон создает count элементов и удаляет их в порядке LIFO, FIFO или случайном.
+// Машиночитаемый вывод: --benchmark_format=json или --benchmark_format=csv,
+// в файл: --benchmark_out=result.json --benchmark_out_format=json
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "common.h"
+#include "pool_resource.h"
+
+namespace {
+
+const size_t element_count = 10000;
+// Элементов в одном маленьком контейнере для сценариев с множеством контейнеров
+const size_t small_size = 16;
+
+// Полезная нагрузка заданного размера
+template <size_t Bytes>
+struct payload {
+    unsigned char data[Bytes];
+    explicit payload(size_t seed = 0) { std::memset(data, static_cast<int>(seed), Bytes); }
+};
+
+// ПОРЯДОК ОСВОБОЖДЕНИЯ
+enum class pattern { lifo, fifo, random };
+
+const char* pattern_name(pattern p) {
+    switch (p) {
+        case pattern::lifo: return "lifo";
+        case pattern::fifo: return "fifo";
+        default: return "random";
+    }
+}
+
+std::vector<size_t> make_order(size_t count, pattern p) {
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), size_t(0));
+    if (p == pattern::lifo) std::reverse(order.begin(), order.end());
+    if (p == pattern::random) std::shuffle(order.begin(), order.end(), std::mt19937(42));
+    return order;
+}
+
+// ВИДЫ АЛЛОКАТОРОВ
+// context живет один прогон и раздает аллокаторы контейнерам
+
+struct std_kind {
+    template <typename T>
+    using type = std::allocator<T>;
+    static std::string name() { return "std"; }
+
+    struct context {
+        template <typename T>
+        type<T> make() { return type<T>(); }
+    };
+};
+
+template <size_t N, typename Policy = default_allocator_policy>
+struct pool_kind {
+    template <typename T>
+    using type = allocator<T, N, Policy>;
+    static std::string name() {
+        return (Policy::monotonic ? "monotonic<" : "pool<") + std::to_string(N) + ">";
+    }
+
+    // Все контейнеры прогона делят одну арену
+    struct context {
+        allocator<char, N, Policy> root;
+        template <typename T>
+        type<T> make() { return type<T>(root); }
+    };
+};
+
+template <typename Resource>
+struct pmr_kind {
+    template <typename T>
+    using type = std::pmr::polymorphic_allocator<T>;
+    static std::string name();
+
+    struct context {
+        Resource resource;
+        template <typename T>
+        type<T> make() { return type<T>(&resource); }
+    };
+};
+
+template <>
+std::string pmr_kind<std::pmr::unsynchronized_pool_resource>::name() { return "pmr_unsync_pool"; }
+template <>
+std::string pmr_kind<std::pmr::synchronized_pool_resource>::name() { return "pmr_sync_pool"; }
+template <>
+std::string pmr_kind<pool_memory_resource<256>>::name() { return "pmr_block_pool<256>"; }
+
+// СЦЕНАРИИ
+// Каждый возвращает число операций выделения и освобождения
+
+template <typename Kind, size_t Bytes>
+size_t run_map(const std::vector<size_t>& order) {
+    using value_type = std::pair<const size_t, payload<Bytes>>;
+    using map_type = std::map<size_t, payload<Bytes>, std::less<size_t>, typename Kind::template type<value_type>>;
+
+    typename Kind::context ctx;
+    map_type map(ctx.template make<value_type>());
+    for (size_t i = 0; i < order.size(); ++i) map.emplace(i, payload<Bytes>(i));
+    for (size_t key : order) map.erase(key);
+    return 2 * order.size();
+}
+
+template <typename Kind, size_t Bytes>
+size_t run_list(const std::vector<size_t>& order) {
+    using list_type = std::list<payload<Bytes>, typename Kind::template type<payload<Bytes>>>;
+
+    typename Kind::context ctx;
+    list_type list(ctx.template make<payload<Bytes>>());
+    std::vector<typename list_type::iterator> nodes;
+    nodes.reserve(order.size());
+    for (size_t i = 0; i < order.size(); ++i) nodes.push_back(list.emplace(list.end(), i));
+    for (size_t index : order) list.erase(nodes[index]);
+    return 2 * order.size();
+}
+
+// Множество коротких векторов: выделения по small_size элементов
+template <typename Kind, size_t Bytes>
+size_t run_vector(const std::vector<size_t>& order) {
+    using vector_type = std::vector<payload<Bytes>, typename Kind::template type<payload<Bytes>>>;
+
+    typename Kind::context ctx;
+    std::vector<vector_type> vectors;
+    vectors.reserve(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        vectors.emplace_back(ctx.template make<payload<Bytes>>());
+        vectors.back().reserve(small_size);
+        vectors.back().emplace_back(i);
+    }
+    for (size_t index : order) {
+        vectors[index].clear();
+        vectors[index].shrink_to_fit();
+    }
+    return 2 * order.size();
+}
+
+// Множество маленьких MyContainer, удаляются целиком в заданном порядке
+template <typename Kind, size_t Bytes>
+size_t run_my_container(const std::vector<size_t>& order) {
+    using container_type = MyContainer<payload<Bytes>, typename Kind::template type<payload<Bytes>>>;
+
+    typename Kind::context ctx;
+    std::vector<std::unique_ptr<container_type>> containers(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        containers[i].reset(new container_type(ctx.template make<payload<Bytes>>()));
+        for (size_t j = 0; j < small_size; ++j) containers[i]->add(payload<Bytes>(j));
+    }
+    for (size_t index : order) containers[index].reset();
+    return 2 * order.size() * small_size;
+}
+
+template <size_t (*Run)(const std::vector<size_t>&)>
+void register_case(const std::string& name, size_t count, pattern p) {
+    benchmark::RegisterBenchmark(name.c_str(), [count, p](benchmark::State& state) {
+        std::vector<size_t> order = make_order(count, p);
+        size_t ops = 0;
+        for (auto _ : state) {
+            ops += Run(order);
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(ops));
+    });
+}
+
+template <typename Kind, size_t Bytes>
+void register_kind() {
+    for (pattern p : {pattern::lifo, pattern::fifo, pattern::random}) {
+        std::string suffix = "/" + Kind::name() + "/" + std::to_string(Bytes) + "B/" + pattern_name(p);
+        register_case<run_map<Kind, Bytes>>("map" + suffix, element_count, p);
+        register_case<run_list<Kind, Bytes>>("list" + suffix, element_count, p);
+        register_case<run_vector<Kind, Bytes>>("vector" + suffix, element_count, p);
+        register_case<run_my_container<Kind, Bytes>>("MyContainer" + suffix, element_count / small_size, p);
+    }
+}
+
+template <size_t Bytes>
+void register_size() {
+    register_kind<std_kind, Bytes>();
+    register_kind<pmr_kind<std::pmr::unsynchronized_pool_resource>, Bytes>();
+    register_kind<pmr_kind<std::pmr::synchronized_pool_resource>, Bytes>();
+    register_kind<pmr_kind<pool_memory_resource<256>>, Bytes>();
+    register_kind<pool_kind<16>, Bytes>();
+    register_kind<pool_kind<256>, Bytes>();
+    register_kind<pool_kind<4096>, Bytes>();
+    register_kind<pool_kind<4096, monotonic_allocator_policy>, Bytes>();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    register_size<8>();
+    register_size<64>();
+    register_size<256>();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,87 @@
+// Сравнение поиска свободных ячеек: массив bool (прежняя реализация) против битовой карты
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "bitmap.h"
+
+namespace {
+
+// Прежний поиск из allocator::allocate: побайтовый проход по массиву флагов
+size_t bool_find_run(const bool* free_slots, size_t capacity, size_t n) {
+    size_t free_count = 0;
+    for (size_t i = 0; i < capacity; ++i) {
+        if (free_slots[i]) {
+            if (++free_count == n) return i - n + 1;
+        } else {
+            free_count = 0;
+        }
+    }
+    return bitmap::npos;
+}
+
+struct layout {
+    std::vector<char> flags;          // vector<bool> упакован, поэтому char
+    std::vector<bitmap::word_t> words;
+};
+
+// occupancy — доля занятых ячеек; tail_free — длина свободного хвоста блока
+layout make_layout(size_t capacity, double occupancy, size_t tail_free, unsigned seed) {
+    layout l;
+    l.flags.assign(capacity, 0);
+    l.words.assign(bitmap::words_for(capacity), 0);
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution is_free(1.0 - occupancy);
+    for (size_t i = 0; i < capacity; ++i) {
+        bool f = i + tail_free >= capacity || is_free(rng);
+        l.flags[i] = f;
+        if (f) bitmap::set_range(l.words.data(), i, 1);
+    }
+    return l;
+}
+
+template <typename F>
+double ns_per_call(size_t iterations, F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) f();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / iterations;
+}
+
+volatile size_t sink;
+
+void run_case(const char* name, size_t capacity, double occupancy, size_t tail_free, size_t n) {
+    layout l = make_layout(capacity, occupancy, tail_free, 42);
+    const bool* flags = reinterpret_cast<const bool*>(l.flags.data());
+    const size_t iterations = 2000000 / capacity * 64 + 1000;
+
+    size_t expected = bool_find_run(flags, capacity, n);
+    size_t got = bitmap::find_run(l.words.data(), l.words.size(), n);
+    if (expected != got) {
+        std::printf("MISMATCH %s: bool=%zu bitmap=%zu\n", name, expected, got);
+        return;
+    }
+
+    double t_bool = ns_per_call(iterations, [&] { sink = bool_find_run(flags, capacity, n); });
+    double t_bits = ns_per_call(iterations, [&] { sink = bitmap::find_run(l.words.data(), l.words.size(), n); });
+
+    std::printf("%-22s %8zu %4zu %12.1f %12.1f %8.1fx %8zu %8zu\n",
+                name, capacity, n, t_bool, t_bits, t_bool / t_bits,
+                capacity * sizeof(bool), l.words.size() * sizeof(bitmap::word_t));
+}
+
+}  // namespace
+
+int main() {
+    std::printf("%-22s %8s %4s %12s %12s %9s %8s %8s\n",
+                "case", "slots", "n", "bool ns", "bitmap ns", "speedup", "bool B", "bitmap B");
+    for (size_t capacity : {1024, 4096, 16384}) {
+        for (size_t n : {1, 4, 32}) {
+            run_case("full, free tail", capacity, 1.0, n, n);
+            run_case("90% used, random", capacity, 0.9, 0, n);
+            run_case("50% used, random", capacity, 0.5, 0, n);
+        }
+    }
+    return 0;
+}
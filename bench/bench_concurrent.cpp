@@ -0,0 +1,87 @@
+// Масштабирование многопоточного выделения: от 1 потока до числа ядер
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bench_utils.h"
+#include "common.h"
+#include "concurrent_allocator.h"
+
+namespace {
+
+struct node {
+    long long value;
+    node* next;
+};
+
+const size_t ops_per_thread = 2000000;
+const size_t batch = 64;
+
+// Каждый поток выделяет пачку узлов и освобождает ее в обратном порядке
+template <typename Alloc>
+void churn(Alloc& alloc) {
+    node* live[batch];
+    for (size_t done = 0; done < ops_per_thread; done += batch) {
+        for (size_t i = 0; i < batch; ++i) {
+            live[i] = alloc.allocate(1);
+            live[i]->value = static_cast<long long>(i);
+        }
+        for (size_t i = batch; i-- > 0;) {
+            bench::do_not_optimize(live[i]->value);
+            alloc.deallocate(live[i], 1);
+        }
+    }
+}
+
+// Однопоточный пул под общим мьютексом — то, что приходилось делать раньше
+struct locked_pool {
+    std::mutex mutex;
+    allocator<node, 4096> alloc;
+
+    node* allocate(size_t n) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return alloc.allocate(n);
+    }
+    void deallocate(node* p, size_t n) {
+        std::lock_guard<std::mutex> lock(mutex);
+        alloc.deallocate(p, n);
+    }
+};
+
+template <typename MakeAlloc>
+double run(size_t threads, MakeAlloc make_alloc) {
+    double seconds = bench::measure_seconds([&] {
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&] {
+                auto&& alloc = make_alloc();
+                churn(alloc);
+            });
+        }
+        for (auto& w : workers) w.join();
+    });
+    return threads * ops_per_thread / seconds / 1e6;
+}
+
+}  // namespace
+
+int main() {
+    size_t cores = std::thread::hardware_concurrency();
+    if (cores == 0) cores = 1;
+
+    std::vector<size_t> thread_counts;
+    for (size_t t = 1; t < cores; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(cores);
+
+    locked_pool shared;
+    std::printf("%8s %18s %18s %18s\n", "threads", "concurrent Mops/s", "std Mops/s", "mutex pool Mops/s");
+    for (size_t threads : thread_counts) {
+        double conc = run(threads, [] { return concurrent_allocator<node>(); });
+        double std_alloc = run(threads, [] { return std::allocator<node>(); });
+        double locked = run(threads, [&shared]() -> locked_pool& { return shared; });
+        std::printf("%8zu %18.1f %18.1f %18.1f\n", threads, conc, std_alloc, locked);
+    }
+    return 0;
+}
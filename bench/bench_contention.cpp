@@ -0,0 +1,88 @@
+// Конкуренция за общий пул: потоки выделяют узлы и освобождают чужие
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bench_utils.h"
+#include "common.h"
+#include "concurrent_allocator.h"
+#include "lockfree_pool.h"
+
+namespace {
+
+struct node {
+    long long value;
+    node* next;
+};
+
+const size_t ops_per_thread = 1000000;
+const size_t exchange_slots = 64;
+
+// Однопоточный пул под общим мьютексом
+struct locked_pool {
+    std::mutex mutex;
+    allocator<node, 4096> alloc;
+
+    node* allocate(size_t n) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return alloc.allocate(n);
+    }
+    void deallocate(node* p, size_t n) {
+        std::lock_guard<std::mutex> lock(mutex);
+        alloc.deallocate(p, n);
+    }
+};
+
+// Узел проходит через общую ячейку обмена и освобождается другим потоком
+template <typename Alloc>
+double run(size_t threads, Alloc& alloc) {
+    std::vector<std::atomic<node*>> exchange(exchange_slots);
+    for (auto& e : exchange) e.store(nullptr);
+
+    double seconds = bench::measure_seconds([&] {
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                for (size_t i = 0; i < ops_per_thread; ++i) {
+                    node* p = alloc.allocate(1);
+                    p->value = static_cast<long long>(i);
+                    node* old = exchange[(i + t * 17) % exchange_slots].exchange(p, std::memory_order_acq_rel);
+                    if (old) {
+                        bench::do_not_optimize(old->value);
+                        alloc.deallocate(old, 1);
+                    }
+                }
+            });
+        }
+        for (auto& w : workers) w.join();
+    });
+    for (auto& e : exchange) {
+        if (node* p = e.exchange(nullptr)) alloc.deallocate(p, 1);
+    }
+    return threads * ops_per_thread / seconds / 1e6;
+}
+
+}  // namespace
+
+int main() {
+    size_t cores = std::thread::hardware_concurrency();
+    if (cores == 0) cores = 1;
+
+    std::vector<size_t> thread_counts;
+    for (size_t t = 1; t < cores * 2; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(cores * 2);
+
+    lockfree_allocator<node> lockfree;
+    concurrent_allocator<node> concurrent;
+    locked_pool locked;
+    std::printf("%8s %16s %18s %18s\n", "threads", "lockfree Mops/s", "concurrent Mops/s", "mutex pool Mops/s");
+    for (size_t threads : thread_counts) {
+        double lf = run(threads, lockfree);
+        double conc = run(threads, concurrent);
+        double mtx = run(threads, locked);
+        std::printf("%8zu %16.1f %18.1f %18.1f\n", threads, lf, conc, mtx);
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+// flat_map против std::map на том же пуле: построение из неупорядоченных ключей,
+// find существующих ключей, lower_bound по случайным ключам и полный обход.
+// Наносекунды на элемент или запрос для нескольких размеров; таблица из 10 ключей —
+// размер таблицы факториалов из allocator.cpp.
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "bench_utils.h"
+#include "common.h"
+#include "flat_map.h"
+
+namespace {
+
+const size_t sizes[] = {10, 1000, 100000, 1000000};
+const size_t probe_count = 1000000;
+
+using pair = std::pair<const int, int>;
+using std_map = std::map<int, int>;
+using pool_map = std::map<int, int, std::less<int>, allocator<pair, 4096>>;
+using pool_flat_map = flat_map<int, int, std::less<int>, allocator<pair, 4096>>;
+
+// std::map строится вставками, flat_map — из диапазона одной сортировкой
+template <typename Map>
+void build(Map& map, const std::vector<std::pair<int, int>>& items) {
+    if constexpr (std::is_same<Map, pool_flat_map>::value) {
+        map.insert(items.begin(), items.end());
+    } else {
+        for (const auto& item : items) map.emplace(item.first, item.second);
+    }
+}
+
+template <typename Map>
+void run(const char* name, const std::vector<std::pair<int, int>>& items,
+         const std::vector<int>& hits, const std::vector<int>& probes) {
+    size_t n = items.size();
+    Map map;
+    double construct = bench::measure_seconds([&] { build(map, items); });
+
+    long long sum = 0;
+    double find = bench::measure_seconds([&] {
+        for (int key : hits) sum += map.find(key)->second;
+    });
+    double lower_bound = bench::measure_seconds([&] {
+        for (int probe : probes) {
+            auto it = map.lower_bound(probe);
+            if (it != map.end()) sum += it->first;
+        }
+    });
+    double iterate = bench::measure_seconds([&] {
+        for (const auto& item : map) sum += item.second;
+    });
+    bench::do_not_optimize(sum);
+
+    std::printf("%-24s %10zu %10.1f %10.1f %10.1f %10.2f\n", name, n, construct / n * 1e9,
+                find / hits.size() * 1e9, lower_bound / probes.size() * 1e9, iterate / n * 1e9);
+}
+
+}  // namespace
+
+int main() {
+    std::printf("%-24s %10s %10s %10s %10s %10s\n", "container", "size", "build ns", "find ns", "lower ns", "iter ns");
+    std::mt19937 random(42);
+    for (size_t n : sizes) {
+        // Различные ключи в случайном порядке
+        std::vector<std::pair<int, int>> items(n);
+        for (size_t i = 0; i < n; ++i) items[i] = {static_cast<int>(i * 2), static_cast<int>(i)};
+        std::shuffle(items.begin(), items.end(), random);
+        std::vector<int> hits(probe_count);
+        for (int& key : hits) key = items[random() % n].first;
+        std::vector<int> probes(probe_count);
+        for (int& probe : probes) probe = static_cast<int>(random() % (2 * n));
+
+        run<std_map>("std::map", items, hits, probes);
+        run<pool_map>("std::map, pool<4096>", items, hits, probes);
+        run<pool_flat_map>("flat_map, pool<4096>", items, hits, probes);
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Упорядоченный MyContainer (skip-list) против std::map на том же пуле.
+// Вставка случайных ключей, поиск существующих, lower_bound по случайным ключам
+// и удаление половины элементов: наносекунды на операцию для нескольких размеров.
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "bench_utils.h"
+#include "common.h"
+
+namespace {
+
+const size_t sizes[] = {1000, 100000, 1000000};
+
+using pool_map = std::map<int, int, std::less<int>, allocator<std::pair<const int, int>, 4096>>;
+using pool_ordered = MyContainer<int, allocator<int, 4096>, ordered_layout<>>;
+
+// Единый интерфейс над map и упорядоченным списком
+void put(pool_map& map, int key) { map.emplace(key, key); }
+void put(pool_ordered& ordered, int key) { ordered.insert(key); }
+int key_of(pool_map::iterator it) { return it->first; }
+int key_of(pool_ordered::iterator it) { return *it; }
+
+template <typename Container>
+void run(const char* name, const std::vector<int>& keys, const std::vector<int>& probes) {
+    size_t n = keys.size();
+    Container container;
+    double insert = bench::measure_seconds([&] {
+        for (int key : keys) put(container, key);
+    });
+
+    long long sum = 0;
+    double find = bench::measure_seconds([&] {
+        for (int key : keys) sum += key_of(container.find(key));
+    });
+    double lower_bound = bench::measure_seconds([&] {
+        for (int probe : probes) {
+            auto it = container.lower_bound(probe);
+            if (it != container.end()) sum += key_of(it);
+        }
+    });
+    bench::do_not_optimize(sum);
+
+    double erase = bench::measure_seconds([&] {
+        for (size_t i = 0; i < n; i += 2) container.erase(container.find(keys[i]));
+    });
+
+    std::printf("%-26s %10zu %10.1f %10.1f %10.1f %10.1f\n", name, n,
+                insert / n * 1e9, find / n * 1e9, lower_bound / probes.size() * 1e9, erase / (n / 2) * 1e9);
+}
+
+}  // namespace
+
+int main() {
+    std::printf("%-26s %10s %10s %10s %10s %10s\n", "container", "size", "insert ns", "find ns", "lower ns", "erase ns");
+    std::mt19937 random(42);
+    for (size_t n : sizes) {
+        // Различные ключи в случайном порядке
+        std::vector<int> keys(n);
+        for (size_t i = 0; i < n; ++i) keys[i] = static_cast<int>(i * 2);
+        std::shuffle(keys.begin(), keys.end(), random);
+        std::vector<int> probes(n);
+        for (int& probe : probes) probe = static_cast<int>(random() % (2 * n));
+
+        run<pool_map>("std::map, pool<4096>", keys, probes);
+        run<pool_ordered>("MyContainer ordered, pool", keys, probes);
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+// Масштабирование параллельных алгоритмов над MyContainer с числом потоков.
+// Для каждого числа потоков: for_each, transform_reduce и find_if (искомый элемент последний),
+// время и ускорение относительно одного потока. Разбиение считается один раз и переиспользуется,
+// отдельной строкой — стоимость split_points.
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "bench_utils.h"
+#include "common.h"
+#include "parallel.h"
+
+namespace {
+
+const size_t element_count = 4000000;
+const int passes = 5;
+
+// Несколько десятков тактов на элемент, чтобы работа, а не обход, определяла время
+double heavy(double value) {
+    for (int i = 0; i < 8; ++i) value = std::sqrt(value * value + 1.0);
+    return value;
+}
+
+template <typename Container>
+void run(const char* name, const std::vector<size_t>& thread_counts) {
+    std::vector<double> source(element_count);
+    for (size_t i = 0; i < element_count; ++i) source[i] = static_cast<double>(i % 1000);
+    Container container(source.begin(), source.end());
+
+    std::printf("%s\n", name);
+    std::printf("%8s %12s %14s %14s %14s\n", "threads", "split ms", "for_each ms", "reduce ms", "find_if ms");
+    double base[3] = {0, 0, 0};
+    for (size_t threads : thread_counts) {
+        thread_pool pool(threads - 1);
+        std::vector<typename Container::iterator> bounds;
+        double split = bench::measure_seconds([&] { bounds = parallel::split(pool, container); });
+
+        double times[3] = {0, 0, 0};
+        double checksum = 0;
+        for (int pass = 0; pass < passes; ++pass) {
+            times[0] += bench::measure_seconds([&] {
+                parallel::for_each(pool, bounds, [](double& value) { value = heavy(value) - value; });
+            });
+            times[1] += bench::measure_seconds([&] {
+                checksum += parallel::transform_reduce(pool, bounds, 0.0, std::plus<double>(), heavy);
+            });
+            times[2] += bench::measure_seconds([&] {
+                auto it = parallel::find_if(pool, bounds, [](double value) { return heavy(value) < 0; });
+                checksum += it == container.end();
+            });
+        }
+        bench::do_not_optimize(checksum);
+
+        if (threads == thread_counts.front()) {
+            for (int i = 0; i < 3; ++i) base[i] = times[i];
+        }
+        std::printf("%8zu %12.2f", threads, split * 1e3);
+        for (int i = 0; i < 3; ++i) {
+            std::printf(" %8.1f x%4.1f", times[i] / passes * 1e3, base[i] / times[i]);
+        }
+        std::printf("\n");
+    }
+    std::printf("\n");
+}
+
+}  // namespace
+
+int main() {
+    size_t hardware = std::thread::hardware_concurrency();
+    std::vector<size_t> thread_counts;
+    for (size_t threads = 1; threads < hardware; threads *= 2) thread_counts.push_back(threads);
+    thread_counts.push_back(hardware ? hardware : 1);
+
+    run<MyContainer<double, allocator<double, 4096>>>("node per element, pool<4096>", thread_counts);
+    run<MyContainer<double, allocator<double, 4096>, unrolled_layout<>>>("unrolled, pool<4096>", thread_counts);
+    return 0;
+}
@@ -0,0 +1,70 @@
+// Стоимость создания контейнеров: миллион короткоживущих пустых контейнеров и миллион
+// контейнеров с одним элементом, наносекунды на контейнер. Пустой контейнер на нашем аллокаторе
+// не создает арену; первый элемент создает арену и первый блок (или берет его из арены).
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "bench_utils.h"
+#include "common.h"
+
+namespace {
+
+const size_t container_count = 1000000;
+const int passes = 3;
+
+// Короткоживущие контейнеры: создание, заполнение, разрушение
+template <typename Container, typename Fill>
+double measure(Fill fill) {
+    double best = 0;
+    for (int pass = 0; pass < passes; ++pass) {
+        size_t checksum = 0;
+        double seconds = bench::measure_seconds([&] {
+            for (size_t i = 0; i < container_count; ++i) {
+                Container container;
+                fill(container);
+                checksum += container.empty();
+            }
+        });
+        bench::do_not_optimize(checksum);
+        if (!pass || seconds < best) best = seconds;
+    }
+    return best / container_count * 1e9;
+}
+
+template <typename Container, typename Insert>
+void run(const char* name, Insert insert) {
+    double empty = measure<Container>([](Container&) {});
+    double one = measure<Container>([&](Container& container) { insert(container); });
+    std::printf("%-40s %12.1f %12.1f\n", name, empty, one);
+}
+
+template <typename Container>
+void run_map(const char* name) {
+    run<Container>(name, [](Container& map) { map[1] = 1; });
+}
+
+template <typename Container>
+void run_list(const char* name) {
+    run<Container>(name, [](Container& list) { list.add(1); });
+}
+
+}  // namespace
+
+int main() {
+    using pair = std::pair<const int, int>;
+
+    std::printf("%-40s %12s %12s\n", "container", "empty ns", "one elem ns");
+    run_map<std::map<int, int>>("std::map, std::allocator");
+    run_map<std::map<int, int, std::less<int>, allocator<pair, 16>>>("std::map, pool<16>");
+    run_map<std::map<int, int, std::less<int>, allocator<pair, 4096>>>("std::map, pool<4096>");
+    run_map<std::map<int, int, std::less<int>, allocator<pair, 16, inline_allocator_policy<512>>>>(
+        "std::map, pool<16>, inline 512 B");
+    run_list<MyContainer<int>>("MyContainer, std::allocator");
+    run_list<MyContainer<int, allocator<int, 16>>>("MyContainer, pool<16>");
+    run_list<MyContainer<int, allocator<int, 4096>>>("MyContainer, pool<4096>");
+    run_list<MyContainer<int, allocator<int, 16, inline_allocator_policy<512>>>>("MyContainer, pool<16>, inline 512 B");
+    run_list<MyContainer<int, allocator<int, 4096>, unrolled_layout<>>>("MyContainer unrolled, pool<4096>");
+    return 0;
+}
@@ -0,0 +1,73 @@
+// Влияние поставщика блоков на обход большого std::map: промахи TLB
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "bench_utils.h"
+#include "common.h"
+
+namespace {
+
+const int element_count = 1000000;
+const int lookups = 1000000;
+// Блоки по 64К узлов: несколько мегабайт на блок, большие страницы имеют смысл
+const size_t block_slots = 1 << 16;
+
+template <typename Provider>
+struct provider_policy : default_allocator_policy {
+    using provider = Provider;
+};
+
+template <typename Map>
+void run(const char* name, const std::vector<int>& insert_order, const std::vector<int>& probes) {
+    Map map;
+    // Ключи вставляются в случайном порядке: соседние по ключу узлы лежат далеко в памяти
+    double build = bench::measure_seconds([&] {
+        for (int key : insert_order) map.emplace(key, key);
+    });
+
+    long long sum = 0;
+    double traverse = bench::measure_seconds([&] {
+        for (int pass = 0; pass < 5; ++pass) {
+            for (const auto& kv : map) sum += kv.second;
+        }
+    });
+    double lookup = bench::measure_seconds([&] {
+        for (int key : probes) sum += map.find(key)->second;
+    });
+    bench::do_not_optimize(sum);
+
+    std::printf("%-22s %10.1f %14.2f %12.1f\n", name,
+                build * 1e9 / insert_order.size(),
+                traverse * 1e9 / (5.0 * map.size()),
+                lookup * 1e9 / probes.size());
+}
+
+template <typename Provider>
+using pooled_map = std::map<int, long long, std::less<int>,
+                            allocator<std::pair<const int, long long>, block_slots, provider_policy<Provider>>>;
+
+}  // namespace
+
+int main() {
+    std::vector<int> keys(element_count);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::mt19937 rng(7);
+    std::shuffle(keys.begin(), keys.end(), rng);
+
+    std::vector<int> probes(lookups);
+    std::uniform_int_distribution<int> pick(0, element_count - 1);
+    for (int& p : probes) p = pick(rng);
+
+    std::printf("%d узлов\n", element_count);
+    std::printf("%-22s %10s %14s %12s\n", "provider", "insert ns", "traverse ns", "find ns");
+    run<std::map<int, long long>>("std::allocator", keys, probes);
+    run<pooled_map<malloc_provider>>("malloc_provider", keys, probes);
+    run<pooled_map<mmap_provider>>("mmap_provider", keys, probes);
+    run<pooled_map<huge_page_provider>>("huge_page_provider", keys, probes);
+    run<pooled_map<numa_local_provider>>("numa_local_provider", keys, probes);
+    return 0;
+}
@@ -0,0 +1,72 @@
+// MyContainer: один элемент в узле против развернутых узлов.
+// Скорость добавления в конец по одному и диапазоном, скорость обхода и байт памяти на элемент.
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "bench_utils.h"
+#include "common.h"
+
+namespace {
+
+const size_t element_count = 1000000;
+const int passes = 20;
+
+// Память узлов видна только через статистику нашей арены
+template <typename Alloc>
+double bytes_per_element(const Alloc& alloc, size_t count) {
+    return static_cast<double>(alloc.get_stats().live_bytes) / count;
+}
+
+template <typename T>
+double bytes_per_element(const std::allocator<T>&, size_t) {
+    return 0;
+}
+
+template <typename Container>
+void run(const char* name, const std::vector<int>& source) {
+    Container container;
+    double append = bench::measure_seconds([&] {
+        for (size_t i = 0; i < element_count; ++i) container.add(static_cast<int>(i));
+    });
+
+    long long sum = 0;
+    double traverse = bench::measure_seconds([&] {
+        for (int pass = 0; pass < passes; ++pass) {
+            for (auto it = container.begin(); it != container.end(); ++it) sum += *it;
+        }
+    });
+    bench::do_not_optimize(sum);
+
+    double bytes = bytes_per_element(container.get_allocator(), element_count);
+    container.clear();
+
+    // Тот же объем диапазоном; разрушение контейнера в замер не входит
+    std::unique_ptr<Container> loaded;
+    double append_range = bench::measure_seconds([&] {
+        loaded.reset(new Container(source.begin(), source.end()));
+    });
+    bench::do_not_optimize(loaded->size());
+    std::printf("%-30s %14.1f %13.1f %15.1f", name, element_count / append / 1e6,
+                element_count / append_range / 1e6, element_count * passes / traverse / 1e6);
+    if (bytes > 0) {
+        std::printf(" %12.1f\n", bytes);
+    } else {
+        std::printf(" %12s\n", "-");
+    }
+}
+
+}  // namespace
+
+int main() {
+    std::vector<int> source(element_count);
+    std::iota(source.begin(), source.end(), 0);
+
+    std::printf("%-30s %14s %13s %15s %12s\n", "layout", "append Mops/s", "range Mops/s", "iterate Mops/s", "bytes/elem");
+    run<MyContainer<int>>("node per element, std", source);
+    run<MyContainer<int, std::allocator<int>, unrolled_layout<>>>("unrolled, std", source);
+    run<MyContainer<int, allocator<int, 4096>>>("node per element, pool<4096>", source);
+    run<MyContainer<int, allocator<int, 4096>, unrolled_layout<>>>("unrolled, pool<4096>", source);
+    return 0;
+}
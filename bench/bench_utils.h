@@ -0,0 +1,22 @@
+#pragma once
+
+#include <chrono>
+
+namespace bench {
+
+// Время выполнения f в секундах
+template <typename F>
+double measure_seconds(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+// Не дает компилятору выбросить вычисление результата
+template <typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}  // namespace bench
@@ -0,0 +1,111 @@
+// Проигрывание трассы выделений на разных конфигурациях аллокатора.
+//   trace_replay <файл>            — проигрывает записанную трассу
+//   trace_replay --record <файл>   — записывает демонстрационную нагрузку в файл
+//   trace_replay                   — записывает демонстрационную нагрузку и сразу проигрывает
+// Для каждой конфигурации: пропускная способность, пик занятой памяти и памяти блоков, число блоков.
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "allocation_trace.h"
+#include "common.h"
+#include "trace_replay.h"
+
+namespace {
+
+const int passes = 5;
+
+struct traced_policy : default_allocator_policy {
+    static constexpr bool record_trace = true;
+};
+
+struct doubling_policy : default_allocator_policy {
+    using growth = doubling_growth;
+};
+
+struct no_retention_policy : default_allocator_policy {
+    using retention = release_empty_blocks;
+};
+
+// Смесь вставок и удалений в std::map и MyContainer, по своей арене на поток
+void demo_workload(unsigned seed) {
+    std::mt19937 random(seed);
+    std::map<int, int, std::less<int>, allocator<std::pair<const int, int>, 64, traced_policy>> map;
+    MyContainer<int, allocator<int, 64, traced_policy>> list;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 2000; ++i) map[static_cast<int>(random() % 10000)] = i;
+        for (int i = 0; i < 1500; ++i) map.erase(static_cast<int>(random() % 10000));
+        for (int i = 0; i < 1000; ++i) list.add(i);
+        for (int i = 0; i < 900 && !list.empty(); ++i) list.erase(list.begin());
+    }
+}
+
+std::vector<trace_record> record_demo() {
+    allocation_trace::start();
+    std::thread other(demo_workload, 2);
+    demo_workload(1);
+    other.join();
+    allocation_trace::stop();
+    if (size_t dropped = allocation_trace::dropped()) {
+        std::fprintf(stderr, "Записей не поместилось в кольца: %zu\n", dropped);
+    }
+    return allocation_trace::drain();
+}
+
+template <size_t init_size, typename Policy = default_allocator_policy>
+void report(const char* name, const prepared_trace& trace) {
+    // Лучший из нескольких прогонов: память от прогона не зависит
+    replay_result best = replay_trace<init_size, Policy>(trace);
+    for (int pass = 1; pass < passes; ++pass) {
+        replay_result result = replay_trace<init_size, Policy>(trace);
+        if (result.seconds < best.seconds) best = result;
+    }
+    std::printf("%-22s %10.2f %12zu %12zu %8zu %8zu %8zu\n", name, best.ops_per_second / 1e6,
+                best.peak_live_bytes / 1024, best.peak_block_bytes / 1024,
+                best.peak_blocks, best.new_blocks, best.final_blocks);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::vector<trace_record> records;
+    if (argc == 3 && std::strcmp(argv[1], "--record") == 0) {
+        records = record_demo();
+        if (!save_trace(argv[2], records)) {
+            std::fprintf(stderr, "Не удалось записать %s\n", argv[2]);
+            return 1;
+        }
+        std::printf("%zu записей в %s\n", records.size(), argv[2]);
+        return 0;
+    }
+    if (argc == 2) {
+        if (!load_trace(argv[1], records)) {
+            std::fprintf(stderr, "Не удалось прочитать трассу %s\n", argv[1]);
+            return 1;
+        }
+    } else if (argc == 1) {
+        records = record_demo();
+    } else {
+        std::fprintf(stderr, "Использование: %s [--record] [файл]\n", argv[0]);
+        return 1;
+    }
+
+    prepared_trace trace(records);
+    std::printf("записей %zu, выделений %u, размеров ячеек %zu, пропущено освобождений %zu\n\n",
+                records.size(), trace.allocations, trace.slot_classes.size(), trace.skipped);
+    std::printf("%-22s %10s %12s %12s %8s %8s %8s\n",
+                "config", "Mops/s", "peak live KB", "peak blk KB", "peak blk", "new blk", "final");
+    report<16>("fixed 16", trace);
+    report<64>("fixed 64", trace);
+    report<256>("fixed 256", trace);
+    report<1024>("fixed 1024", trace);
+    report<4096>("fixed 4096", trace);
+    report<16, doubling_policy>("doubling from 16", trace);
+    report<64, no_retention_policy>("fixed 64, no retention", trace);
+    report<1024, monotonic_allocator_policy>("monotonic 1024", trace);
+    return 0;
+}
@@ -6,7 +6,8 @@
 #include <cstddef>
 #include <type_traits>
 #include <typeinfo>
-#include "common.h"
+#include "flat_map.h"
+#include "print.h"
 
 int main() {
 
@@ -22,6 +23,11 @@ int main() {
     std::map<int, int, std::less<int>, CustomMapAlloc> custom_map;
     fill_custom_map(custom_map);
     print_map(custom_map, "std::map (наш аллокатор, 10 элементов)");
+
+    // 3. Та же таблица в плоском словаре с нашим аллокатором
+    custom_flat_map flat_table;
+    fill_custom_flat_map(flat_table);
+    print_map(flat_table, "flat_map (наш аллокатор, 10 элементов)");
     
     // 4. Создание и заполнение нашего контейнера
     MyContainer<int> my_container;
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// ТРАССА ВЫДЕЛЕНИЙ
+// При Policy::record_trace == true пул пишет каждое allocate/deallocate в трассу,
+// пока запись включена через allocation_trace::start(). Каждый поток пишет в свое
+// кольцо без блокировок; в переполненное кольцо записи не попадают, а считаются
+// в dropped(). reset() арены в трассу не пишется.
+
+enum class trace_op : std::uint8_t {
+    allocate,
+    deallocate
+};
+
+struct trace_record {
+    std::uint64_t timestamp_ns;    // от последнего start()
+    std::uint64_t slot;            // адрес первой ячейки: связывает выделение с освобождением
+    std::uint32_t count;           // число ячеек
+    std::uint32_t slot_size;
+    std::uint16_t thread;          // номер потока в трассе, по порядку первой записи
+    std::uint8_t slot_align_log2;
+    trace_op op;
+};
+
+static_assert(sizeof(trace_record) == 32, "trace_record must stay compact");
+
+namespace detail {
+
+// Кольцо одного потока: пишет только владелец, читает только drain под мьютексом трассы
+class trace_ring {
+public:
+    static constexpr size_t capacity = size_t(1) << 16;
+
+    const std::uint16_t thread;
+    std::atomic<size_t> dropped{0};
+
+    explicit trace_ring(std::uint16_t thread) : thread(thread), records(new trace_record[capacity]) {}
+
+    void push(const trace_record& record) noexcept {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == capacity) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        records[h & (capacity - 1)] = record;
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    void drain(std::vector<trace_record>& out) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t h = head.load(std::memory_order_acquire);
+        for (size_t i = t; i != h; ++i) out.push_back(records[i & (capacity - 1)]);
+        tail.store(h, std::memory_order_release);
+    }
+
+private:
+    std::unique_ptr<trace_record[]> records;
+    // Индексы на разных линиях: писатель и читатель не мешают друг другу
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+};
+
+inline std::uint8_t log2_of(size_t value) {
+    std::uint8_t result = 0;
+    while (value > 1) {
+        value >>= 1;
+        ++result;
+    }
+    return result;
+}
+
+}  // namespace detail
+
+// Глобальная трасса процесса. Кольца потоков живут до конца процесса,
+// поэтому записи завершившихся потоков не теряются.
+class allocation_trace {
+public:
+    // Сбрасывает накопленное и начинает запись, время отсчитывается от этого момента
+    static void start() {
+        state& s = instance();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        std::vector<trace_record> discarded;
+        for (auto& ring : s.rings) {
+            ring->drain(discarded);
+            ring->dropped.store(0, std::memory_order_relaxed);
+        }
+        s.epoch_ns.store(now_ns(), std::memory_order_release);
+        s.on.store(true, std::memory_order_release);
+    }
+
+    static void stop() noexcept {
+        instance().on.store(false, std::memory_order_release);
+    }
+
+    static bool recording() noexcept {
+        return instance().on.load(std::memory_order_relaxed);
+    }
+
+    // Забирает записи всех потоков, упорядоченные по времени. Можно вызывать во время записи.
+    static std::vector<trace_record> drain() {
+        state& s = instance();
+        std::vector<trace_record> records;
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            for (auto& ring : s.rings) ring->drain(records);
+        }
+        std::stable_sort(records.begin(), records.end(), [](const trace_record& a, const trace_record& b) {
+            return a.timestamp_ns < b.timestamp_ns;
+        });
+        return records;
+    }
+
+    // Записи, не попавшие в переполненные кольца с последнего start()
+    static size_t dropped() {
+        state& s = instance();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        size_t total = 0;
+        for (auto& ring : s.rings) total += ring->dropped.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    static void record(trace_op op, const void* slot, size_t count, size_t slot_size, size_t slot_align) noexcept {
+        state& s = instance();
+        if (!s.on.load(std::memory_order_acquire)) return;
+        detail::trace_ring* ring = ring_for_thread(s);
+        if (!ring) return;
+        // Запись, начатая до повторного start(), может оказаться раньше новой эпохи
+        std::int64_t elapsed = now_ns() - s.epoch_ns.load(std::memory_order_acquire);
+        trace_record record;
+        record.timestamp_ns = static_cast<std::uint64_t>(std::max<std::int64_t>(elapsed, 0));
+        record.slot = reinterpret_cast<std::uintptr_t>(slot);
+        record.count = static_cast<std::uint32_t>(count);
+        record.slot_size = static_cast<std::uint32_t>(slot_size);
+        record.thread = ring->thread;
+        record.slot_align_log2 = detail::log2_of(slot_align);
+        record.op = op;
+        ring->push(record);
+    }
+
+private:
+    static constexpr size_t max_threads = 65536;
+
+    struct state {
+        std::atomic<bool> on{false};
+        // Наносекунды steady_clock на момент start(). Атомарна: повторный start()
+        // переписывает ее, пока другие потоки еще пишут
+        std::atomic<std::int64_t> epoch_ns{0};
+        std::mutex mutex;
+        std::vector<std::unique_ptr<detail::trace_ring>> rings;
+    };
+
+    static std::int64_t now_ns() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static state& instance() noexcept {
+        static state s;
+        return s;
+    }
+
+    // Кольцо заводится при первой записи потока; без памяти или сверх max_threads поток не пишется
+    static detail::trace_ring* ring_for_thread(state& s) noexcept {
+        thread_local detail::trace_ring* ring = nullptr;
+        thread_local bool failed = false;
+        if (ring || failed) return ring;
+        try {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            if (s.rings.size() < max_threads) {
+                s.rings.emplace_back(new detail::trace_ring(static_cast<std::uint16_t>(s.rings.size())));
+                ring = s.rings.back().get();
+            }
+        } catch (...) {
+        }
+        failed = !ring;
+        return ring;
+    }
+};
+
+// ФАЙЛ ТРАССЫ
+// Заголовок (магия, версия, число записей) и записи как есть, в порядке байт записавшей машины
+
+namespace detail {
+
+struct trace_file_header {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t count;
+};
+
+constexpr char trace_magic[4] = {'A', 'T', 'R', 'C'};
+constexpr std::uint32_t trace_version = 1;
+
+}  // namespace detail
+
+inline bool save_trace(const char* path, const std::vector<trace_record>& records) {
+    std::FILE* file = std::fopen(path, "wb");
+    if (!file) return false;
+    detail::trace_file_header header;
+    std::copy(detail::trace_magic, detail::trace_magic + 4, header.magic);
+    header.version = detail::trace_version;
+    header.count = records.size();
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(records.data(), sizeof(trace_record), records.size(), file) == records.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+// false, если файла нет, он обрезан или записан другой версией
+inline bool load_trace(const char* path, std::vector<trace_record>& records) {
+    std::FILE* file = std::fopen(path, "rb");
+    if (!file) return false;
+    detail::trace_file_header header;
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+              std::equal(detail::trace_magic, detail::trace_magic + 4, header.magic) &&
+              header.version == detail::trace_version;
+    if (ok) {
+        // Число записей из заголовка сверяется с размером файла до выделения памяти под них
+        long body = std::ftell(file);
+        ok = body >= 0 && std::fseek(file, 0, SEEK_END) == 0;
+        long end = ok ? std::ftell(file) : -1;
+        ok = ok && end >= body && std::fseek(file, body, SEEK_SET) == 0 &&
+             header.count <= static_cast<std::uint64_t>(end - body) / sizeof(trace_record);
+    }
+    if (ok) {
+        records.resize(header.count);
+        ok = std::fread(records.data(), sizeof(trace_record), records.size(), file) == records.size();
+    }
+    std::fclose(file);
+    if (!ok) records.clear();
+    return ok;
+}
+
+namespace detail {
+
+// Запись трассы из пула; при Policy::record_trace == false вызовы исчезают при компиляции
+template <bool Enabled>
+struct trace_hook {
+    static void on_allocate(const void* p, size_t n, size_t slot_size, size_t slot_align) noexcept {
+        allocation_trace::record(trace_op::allocate, p, n, slot_size, slot_align);
+    }
+    static void on_deallocate(const void* p, size_t n, size_t slot_size, size_t slot_align) noexcept {
+        allocation_trace::record(trace_op::deallocate, p, n, slot_size, slot_align);
+    }
+};
+
+template <>
+struct trace_hook<false> {
+    static void on_allocate(const void*, size_t, size_t, size_t) noexcept {}
+    static void on_deallocate(const void*, size_t, size_t, size_t) noexcept {}
+};
+
+}  // namespace detail
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+// СТАТИСТИКА АЛЛОКАТОРА
+// Снимок состояния всей арены. Структура (блоки, заполнение, фрагментация) собирается
+// обходом блоков в момент запроса и доступна всегда. Счетчики событий ведутся только
+// при Policy::collect_stats == true, иначе остаются нулями и ничего не стоят.
+struct allocator_stats {
+    // Корзины гистограммы заполнения: [0%, 10%), [10%, 20%), ..., [90%, 100%), ровно 100%
+    static constexpr size_t histogram_buckets = 11;
+
+    bool counters_enabled = false;
+    size_t init_size = 0;
+
+    // Структура
+    size_t pool_count = 0;
+    size_t block_count = 0;
+    size_t dedicated_block_count = 0;
+    size_t empty_block_count = 0;
+    size_t live_bytes = 0;
+    size_t capacity_bytes = 0;
+    size_t free_bytes = 0;
+    size_t largest_free_run_bytes = 0;   // самый длинный участок свободных ячеек подряд
+    double fragmentation = 0;            // 1 - largest_free_run_bytes / free_bytes
+    size_t fill_histogram[histogram_buckets] = {};
+
+    // Счетчики событий
+    size_t peak_live_bytes = 0;
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t new_blocks = 0;               // медленный путь: выделение блока у поставщика
+    size_t released_blocks = 0;
+    size_t double_frees = 0;
+    size_t foreign_frees = 0;
+};
+
+namespace detail {
+
+// Счетчики арены, общие для всех ее подпулов
+template <bool Enabled>
+struct stats_counters {
+    size_t live_bytes = 0;
+    size_t peak_live_bytes = 0;
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t new_blocks = 0;
+    size_t released_blocks = 0;
+    size_t double_frees = 0;
+    size_t foreign_frees = 0;
+
+    void on_allocate(size_t bytes, size_t count = 1) {
+        allocations += count;
+        live_bytes += bytes;
+        if (live_bytes > peak_live_bytes) peak_live_bytes = live_bytes;
+    }
+    void on_deallocate(size_t bytes, size_t double_freed) noexcept {
+        ++deallocations;
+        live_bytes -= bytes;
+        double_frees += double_freed;
+    }
+    void on_new_block() { ++new_blocks; }
+    void on_release_block() noexcept { ++released_blocks; }
+    void on_foreign_free() noexcept { ++foreign_frees; }
+    void on_reset(size_t bytes) noexcept { live_bytes -= bytes; }
+
+    void fill(allocator_stats& stats) const {
+        stats.peak_live_bytes = peak_live_bytes;
+        stats.allocations = allocations;
+        stats.deallocations = deallocations;
+        stats.new_blocks = new_blocks;
+        stats.released_blocks = released_blocks;
+        stats.double_frees = double_frees;
+        stats.foreign_frees = foreign_frees;
+    }
+};
+
+// Сбор выключен: все вызовы пустые и исчезают при компиляции
+template <>
+struct stats_counters<false> {
+    void on_allocate(size_t, size_t = 1) {}
+    void on_deallocate(size_t, size_t) noexcept {}
+    void on_new_block() {}
+    void on_release_block() noexcept {}
+    void on_foreign_free() noexcept {}
+    void on_reset(size_t) noexcept {}
+    void fill(allocator_stats&) const {}
+};
+
+}  // namespace detail
+
+// Снимок в JSON одной строкой, без зависимостей от потоков ввода-вывода
+inline std::string to_json(const allocator_stats& stats) {
+    std::string out = "{";
+    auto field = [&out](const char* name, const std::string& value) {
+        if (out.size() > 1) out += ",";
+        out += "\"";
+        out += name;
+        out += "\":";
+        out += value;
+    };
+
+    char fragmentation[32];
+    std::snprintf(fragmentation, sizeof(fragmentation), "%.4f", stats.fragmentation);
+    std::string histogram = "[";
+    for (size_t i = 0; i < allocator_stats::histogram_buckets; ++i) {
+        if (i) histogram += ",";
+        histogram += std::to_string(stats.fill_histogram[i]);
+    }
+    histogram += "]";
+
+    field("counters_enabled", stats.counters_enabled ? "true" : "false");
+    field("init_size", std::to_string(stats.init_size));
+    field("pool_count", std::to_string(stats.pool_count));
+    field("block_count", std::to_string(stats.block_count));
+    field("dedicated_block_count", std::to_string(stats.dedicated_block_count));
+    field("empty_block_count", std::to_string(stats.empty_block_count));
+    field("live_bytes", std::to_string(stats.live_bytes));
+    field("capacity_bytes", std::to_string(stats.capacity_bytes));
+    field("free_bytes", std::to_string(stats.free_bytes));
+    field("largest_free_run_bytes", std::to_string(stats.largest_free_run_bytes));
+    field("fragmentation", fragmentation);
+    field("fill_histogram", histogram);
+    field("peak_live_bytes", std::to_string(stats.peak_live_bytes));
+    field("allocations", std::to_string(stats.allocations));
+    field("deallocations", std::to_string(stats.deallocations));
+    field("new_blocks", std::to_string(stats.new_blocks));
+    field("released_blocks", std::to_string(stats.released_blocks));
+    field("double_frees", std::to_string(stats.double_frees));
+    field("foreign_frees", std::to_string(stats.foreign_frees));
+    out += "}";
+    return out;
+}
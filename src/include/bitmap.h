@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// БИТОВАЯ КАРТА СВОБОДНЫХ ЯЧЕЕК
+// Один бит на ячейку, упакованный в 64-битные слова: 1 — ячейка свободна, 0 — занята.
+// Биты за пределами ёмкости блока всегда равны 0, поэтому поиск не выходит за границу.
+namespace bitmap {
+    using word_t = std::uint64_t;
+
+    constexpr size_t word_bits = 64;
+    constexpr size_t npos = static_cast<size_t>(-1);
+    constexpr word_t all_ones = ~word_t(0);
+
+    constexpr size_t words_for(size_t bits) {
+        return (bits + word_bits - 1) / word_bits;
+    }
+
+    // Количество младших нулевых битов (w != 0)
+    inline size_t ctz(word_t w) {
+#if defined(__GNUC__)
+        return static_cast<size_t>(__builtin_ctzll(w));
+#else
+        size_t n = 0;
+        while (!(w & 1)) { w >>= 1; ++n; }
+        return n;
+#endif
+    }
+
+    // Количество старших нулевых битов (w != 0)
+    inline size_t clz(word_t w) {
+#if defined(__GNUC__)
+        return static_cast<size_t>(__builtin_clzll(w));
+#else
+        size_t n = 0;
+        while (!(w & (word_t(1) << 63))) { w <<= 1; ++n; }
+        return n;
+#endif
+    }
+
+    inline size_t popcount(word_t w) {
+#if defined(__GNUC__)
+        return static_cast<size_t>(__builtin_popcountll(w));
+#else
+        size_t n = 0;
+        for (; w; w &= w - 1) ++n;
+        return n;
+#endif
+    }
+
+    // Маска битов [from, from + count) внутри одного слова, 0 < count <= 64 - from
+    inline word_t range_mask(size_t from, size_t count) {
+        return (count == word_bits ? all_ones : ((word_t(1) << count) - 1)) << from;
+    }
+
+    inline bool test(const word_t* words, size_t pos) {
+        return (words[pos / word_bits] >> (pos % word_bits)) & 1;
+    }
+
+    // Первые bits ячеек свободны, хвост последнего слова занят
+    inline void fill(word_t* words, size_t bits) {
+        size_t full = bits / word_bits;
+        for (size_t i = 0; i < full; ++i) {
+            words[i] = all_ones;
+        }
+        if (bits % word_bits) {
+            words[full] = range_mask(0, bits % word_bits);
+        }
+    }
+
+    // Применяет f(слово, маска) ко всем словам, которые задевает диапазон [pos, pos + count)
+    template <typename F>
+    inline void for_each_word(size_t pos, size_t count, F&& f) {
+        while (count) {
+            size_t bit = pos % word_bits;
+            size_t take = word_bits - bit < count ? word_bits - bit : count;
+            f(pos / word_bits, range_mask(bit, take));
+            pos += take;
+            count -= take;
+        }
+    }
+
+    // Пометить диапазон свободным
+    inline void set_range(word_t* words, size_t pos, size_t count) {
+        for_each_word(pos, count, [words](size_t i, word_t mask) { words[i] |= mask; });
+    }
+
+    // Пометить диапазон занятым
+    inline void clear_range(word_t* words, size_t pos, size_t count) {
+        for_each_word(pos, count, [words](size_t i, word_t mask) { words[i] &= ~mask; });
+    }
+
+    // Сколько ячеек диапазона уже свободно
+    inline size_t count_set(const word_t* words, size_t pos, size_t count) {
+        size_t result = 0;
+        for_each_word(pos, count, [words, &result](size_t i, word_t mask) {
+            result += popcount(words[i] & mask);
+        });
+        return result;
+    }
+
+    // Индекс первого ненулевого слова в [from, nwords) или nwords.
+    // Полностью занятые участки пропускаются по 2-4 слова за сравнение.
+    inline size_t find_nonzero_word(const word_t* words, size_t from, size_t nwords) {
+        size_t i = from;
+#if defined(__AVX2__)
+        for (; i + 4 <= nwords; i += 4) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+            if (!_mm256_testz_si256(v, v)) break;
+        }
+#elif defined(__SSE2__)
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 2 <= nwords; i += 2) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)) != 0xFFFF) break;
+        }
+#endif
+        for (; i < nwords; ++i) {
+            if (words[i]) return i;
+        }
+        return nwords;
+    }
+
+    // Биты w, с которых начинается серия из n единиц внутри слова (1 <= n <= 64).
+    // Удвоение длины серии: log2(n) сдвигов вместо n.
+    inline word_t run_starts(word_t w, size_t n) {
+        size_t len = 1;
+        while (len < n && w) {
+            size_t shift = len < n - len ? len : n - len;
+            w &= w >> shift;
+            len += shift;
+        }
+        return w;
+    }
+
+    // Поиск n подряд идущих свободных ячеек. Возвращает индекс первой или npos.
+    inline size_t find_run(const word_t* words, size_t nwords, size_t n) {
+        if (n == 0) return npos;
+        if (n == 1) {
+            size_t i = find_nonzero_word(words, 0, nwords);
+            return i == nwords ? npos : i * word_bits + ctz(words[i]);
+        }
+
+        size_t run = 0;  // длина свободной серии, заканчивающейся на предыдущем слове
+        for (size_t i = 0; i < nwords; ++i) {
+            word_t w = words[i];
+            if (w == all_ones) {
+                if (run + word_bits >= n) return i * word_bits - run;
+                run += word_bits;
+                continue;
+            }
+            if (w == 0) {
+                run = 0;
+                i = find_nonzero_word(words, i + 1, nwords) - 1;
+                continue;
+            }
+            // Продолжение серии из предыдущего слова
+            if (run + ctz(~w) >= n) return i * word_bits - run;
+            // Серия целиком внутри слова
+            if (n <= word_bits && popcount(w) >= n) {
+                word_t starts = run_starts(w, n);
+                if (starts) return i * word_bits + ctz(starts);
+            }
+            // Старшие единицы начинают новую серию
+            run = clz(~w);
+        }
+        return npos;
+    }
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// ПОСТАВЩИКИ ПАМЯТИ ДЛЯ БЛОКОВ
+// allocate(bytes) возвращает память под данные блока или nullptr,
+// deallocate(p, bytes) получает тот же размер, что был запрошен.
+// alignment — выравнивание, которое поставщик гарантирует всегда; если ячейкам нужно
+// больше, пул запрашивает блок с запасом и выравнивает начало данных сам.
+// Если нужный механизм недоступен, поставщик тихо откатывается на более простой.
+
+// malloc/free — поведение по умолчанию
+struct malloc_provider {
+    static constexpr size_t alignment = alignof(std::max_align_t);
+
+    static void* allocate(size_t bytes) noexcept { return malloc(bytes); }
+    static void deallocate(void* p, size_t) noexcept { free(p); }
+};
+
+#if defined(__linux__)
+
+namespace detail {
+    constexpr size_t huge_page_size = size_t(2) << 20;
+    // Наименьший размер страницы на поддерживаемых платформах
+    constexpr size_t min_page_size = 4096;
+
+    inline size_t round_up(size_t bytes, size_t granularity) {
+        return (bytes + granularity - 1) / granularity * granularity;
+    }
+
+    inline void* map_anonymous(size_t bytes, int extra_flags) noexcept {
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, -1, 0);
+        return p == MAP_FAILED ? nullptr : p;
+    }
+}
+
+// Анонимный mmap: блок сразу возвращается системе при освобождении,
+// не оседая в кэшах malloc. Размер округляется до страницы.
+struct mmap_provider {
+    static constexpr size_t alignment = detail::min_page_size;
+
+    static void* allocate(size_t bytes) noexcept {
+        return detail::map_anonymous(bytes, 0);
+    }
+    static void deallocate(void* p, size_t bytes) noexcept {
+        munmap(p, bytes);
+    }
+};
+
+// Блоки на больших страницах: сначала MAP_HUGETLB из зарезервированного пула,
+// затем обычный mmap с подсказкой MADV_HUGEPAGE для прозрачных больших страниц.
+// Размер округляется до 2 МиБ, поэтому подходит для блоков от мегабайта.
+struct huge_page_provider {
+    // Откат на обычный mmap гарантирует только выравнивание страницы
+    static constexpr size_t alignment = detail::min_page_size;
+
+    static void* allocate(size_t bytes) noexcept {
+        size_t length = detail::round_up(bytes, detail::huge_page_size);
+#if defined(MAP_HUGETLB)
+        if (void* p = detail::map_anonymous(length, MAP_HUGETLB)) return p;
+#endif
+        void* p = detail::map_anonymous(length, 0);
+#if defined(MADV_HUGEPAGE)
+        if (p) madvise(p, length, MADV_HUGEPAGE);
+#endif
+        return p;
+    }
+    static void deallocate(void* p, size_t bytes) noexcept {
+        munmap(p, detail::round_up(bytes, detail::huge_page_size));
+    }
+};
+
+// mmap с предпочтением NUMA-узла того процессора, на котором выделяется блок.
+// Без поддержки NUMA в ядре mbind завершается ошибкой и остается политика по умолчанию.
+struct numa_local_provider {
+    static constexpr size_t alignment = detail::min_page_size;
+
+    static void* allocate(size_t bytes) noexcept {
+        void* p = detail::map_anonymous(bytes, 0);
+#if defined(SYS_mbind) && defined(SYS_getcpu)
+        unsigned cpu = 0;
+        unsigned node = 0;
+        if (p && syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 && node < 8 * sizeof(unsigned long)) {
+            const int mpol_preferred = 1;
+            unsigned long nodemask = 1UL << node;
+            syscall(SYS_mbind, p, bytes, mpol_preferred, &nodemask, 8 * sizeof(nodemask) + 1, 0);
+        }
+#endif
+        return p;
+    }
+    static void deallocate(void* p, size_t bytes) noexcept {
+        munmap(p, bytes);
+    }
+};
+
+#else
+
+// Без mmap все поставщики работают через malloc
+using mmap_provider = malloc_provider;
+using huge_page_provider = malloc_provider;
+using numa_local_provider = malloc_provider;
+
+#endif
@@ -1,412 +1,2986 @@
+#pragma once
 
-#include <iostream>
+#include <ostream>
+#include <atomic>
+#include <cstdio>
 #include <vector>
 #include <map>
 #include <list>
 #include <memory>
+#include <new>
 #include <cstddef>
+#include <cstdint>
 #include <type_traits>
 #include <typeinfo>
 #include <cstdlib>
 #include <string>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <optional>
+
+#include "allocation_trace.h"
+#include "allocator_stats.h"
+#include "bitmap.h"
+#include "block_provider.h"
+
+// ПОЛИТИКИ РОСТА БЛОКОВ
+// next_capacity(init_size, previous) — ёмкость следующего блока, previous == 0 для первого блока
+
+// Все блоки по init_size ячеек
+struct fixed_growth {
+    static size_t next_capacity(size_t init_size, size_t) { return init_size; }
+};
+
+// Каждый следующий блок в Factor раз больше предыдущего, но не больше MaxCapacity
+template <size_t Factor, size_t MaxCapacity = static_cast<size_t>(-1)>
+struct geometric_growth {
+    static_assert(Factor >= 1, "Factor must be at least 1");
+
+    static size_t next_capacity(size_t init_size, size_t previous) {
+        size_t limit = MaxCapacity < init_size ? init_size : MaxCapacity;
+        if (!previous) return init_size;
+        if (previous > limit / Factor) return limit;
+        return previous * Factor;
+    }
+};
+
+using doubling_growth = geometric_growth<2>;
+
+template <size_t MaxCapacity>
+using capped_growth = geometric_growth<2, MaxCapacity>;
+
+// ПОЛИТИКИ УДЕРЖАНИЯ ПУСТЫХ БЛОКОВ
+// Опустевший обычный блок остается в пуле, пока пустых блоков не больше max_empty_blocks,
+// иначе сразу возвращается системе. Текущий блок пула не возвращается никогда и удерживается
+// сверх K: всего пустых блоков может быть K + 1, а release_empty_blocks оставляет один.
+// Отдельные блоки под большие запросы не удерживаются.
+template <size_t K>
+struct keep_empty_blocks {
+    static constexpr size_t max_empty_blocks = K;
+};
+
+using keep_all_blocks = keep_empty_blocks<static_cast<size_t>(-1)>;
+using release_empty_blocks = keep_empty_blocks<0>;
+
+// РАСКЛАДКА ЯЧЕЕК
+// slot_size(size, align) и slot_align(align) — шаг и выравнивание ячеек для объекта
+// размера size с выравниванием align. Блок всегда выровнен на slot_align.
+namespace detail {
+    constexpr size_t cache_line_size = 64;
+
+    constexpr size_t align_up(size_t value, size_t align) {
+        return (value + align - 1) / align * align;
+    }
+}
+
+// Ячейки вплотную с шагом sizeof(T), выравнивание alignof(T)
+struct packed_layout {
+    static constexpr size_t slot_size(size_t size, size_t) { return size; }
+    static constexpr size_t slot_align(size_t align) { return align; }
+};
+
+// Каждая ячейка занимает целое число кэш-линий: объекты разных потоков
+// не делят линию (false sharing), ценой памяти на мелких объектах.
+// Массив из n > 1 объектов лежит вплотную и занимает ceil(n * sizeof(T) / slot_size) ячеек.
+struct cache_line_layout {
+    static constexpr size_t slot_align(size_t align) {
+        return align > detail::cache_line_size ? align : detail::cache_line_size;
+    }
+    static constexpr size_t slot_size(size_t size, size_t align) {
+        return detail::align_up(size, slot_align(align));
+    }
+};
+
+// ПОЛИТИКИ ОБРАБОТКИ ОШИБОК
+// Ошибки использования аллокатора не бросают исключений из noexcept deallocate,
+// а передаются в Policy::errors::report. Ни одна политика, кроме abort_on_error,
+// не выполняет ввода-вывода, поэтому путь освобождения остается дешевым.
+enum class allocation_error {
+    double_free,      // ячейка уже свободна
+    foreign_pointer   // указатель не принадлежит ни одному блоку пула
+};
+
+struct allocation_error_info {
+    allocation_error kind;
+    const void* address;
+    size_t slot;       // номер ячейки в блоке, для foreign_pointer — 0
+    size_t block_id;   // номер блока в пуле, для foreign_pointer — 0
+};
+
+// Ошибки игнорируются
+struct silent_errors {
+    static void report(const allocation_error_info&) noexcept {}
+};
+
+// Ошибки только подсчитываются, счетчики общие для процесса
+struct count_errors {
+    static void report(const allocation_error_info& info) noexcept {
+        counter(info.kind).fetch_add(1, std::memory_order_relaxed);
+    }
+    static size_t count(allocation_error kind) noexcept {
+        return counter(kind).load(std::memory_order_relaxed);
+    }
+    static void reset() noexcept {
+        counter(allocation_error::double_free).store(0, std::memory_order_relaxed);
+        counter(allocation_error::foreign_pointer).store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static std::atomic<size_t>& counter(allocation_error kind) noexcept {
+        static std::atomic<size_t> counters[2];
+        return counters[static_cast<size_t>(kind)];
+    }
+};
+
+// Сообщение в stderr и аварийное завершение: для отладочных сборок
+struct abort_on_error {
+    static void report(const allocation_error_info& info) noexcept {
+        std::fprintf(stderr, "ОШИБКА: %s по адресу %p, слот %zu, в блоке %zu\n",
+                     info.kind == allocation_error::double_free ? "Повторное освобождение" : "Освобождение чужого указателя",
+                     info.address, info.slot, info.block_id);
+        std::abort();
+    }
+};
+
+// Пользовательский обработчик, по умолчанию не установлен
+struct callback_errors {
+    using handler_type = void (*)(const allocation_error_info&) noexcept;
+
+    static void report(const allocation_error_info& info) noexcept {
+        if (handler_type h = handler().load(std::memory_order_acquire)) h(info);
+    }
+    static void set_handler(handler_type h) noexcept {
+        handler().store(h, std::memory_order_release);
+    }
+
+private:
+    static std::atomic<handler_type>& handler() noexcept {
+        static std::atomic<handler_type> h(nullptr);
+        return h;
+    }
+};
+
+// Настройки аллокатора по умолчанию. Свои настройки наследуются от этой структуры
+// и переопределяют нужные члены, например:
+//   struct my_policy : default_allocator_policy { using growth = doubling_growth; };
+struct default_allocator_policy {
+    using growth = fixed_growth;
+    // Откуда берется память блоков: malloc_provider, mmap_provider, huge_page_provider, numa_local_provider
+    using provider = malloc_provider;
+    // Один горячий запасной блок гасит выделение/освобождение на границе блока
+    using retention = keep_empty_blocks<1>;
+    // Ошибки освобождения: silent_errors, count_errors, abort_on_error, callback_errors
+    using errors = count_errors;
+    // Шаг ячеек: packed_layout или cache_line_layout
+    using layout = packed_layout;
+    // Счетчики событий для get_stats(): выключены, чтобы не трогать горячий путь
+    static constexpr bool collect_stats = false;
+    // Запись allocate/deallocate в allocation_trace между start() и stop()
+    static constexpr bool record_trace = false;
+    // Память под первый блок прямо в арене, в той же аллокации, что и сама арена:
+    // маленький контейнер не обращается к поставщику, пока не переполнит ее. 0 — выключено.
+    static constexpr size_t inline_bytes = 0;
+    // Монотонный режим: выделение сдвигает указатель, deallocate ничего не делает,
+    // память возвращается только через reset() или вместе с ареной
+    static constexpr bool monotonic = false;
+};
+
+struct monotonic_allocator_policy : default_allocator_policy {
+    static constexpr bool monotonic = true;
+};
+
+template <size_t Bytes>
+struct inline_allocator_policy : default_allocator_policy {
+    static constexpr size_t inline_bytes = Bytes;
+};
+
+// ПУЛ ЯЧЕЕК
+namespace detail {
+
+// Память арены под первый блок
+template <size_t Bytes>
+struct inline_storage {
+    alignas(std::max_align_t) unsigned char bytes[Bytes];
+
+    void* data() { return bytes; }
+    static constexpr size_t size() { return Bytes; }
+};
+
+template <>
+struct inline_storage<0> {
+    void* data() { return nullptr; }
+    static constexpr size_t size() { return 0; }
+};
+
+// Вектор с местом под первые N значений внутри себя: каталог пула из нескольких
+// блоков не обращается к куче. Только для тривиально копируемых значений (указателей).
+template <typename T, size_t N>
+class small_vector {
+private:
+    static_assert(std::is_trivially_copyable<T>::value, "small_vector stores trivially copyable values");
+
+    T* first;
+    size_t count;
+    size_t capacity_;
+    T local[N];
+
+    void grow_to(size_t n) {
+        T* data = static_cast<T*>(::operator new(n * sizeof(T)));
+        std::copy(first, first + count, data);
+        if (first != local) ::operator delete(first);
+        first = data;
+        capacity_ = n;
+    }
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    small_vector() noexcept : first(local), count(0), capacity_(N) {}
+    small_vector(const small_vector&) = delete;
+    small_vector& operator=(const small_vector&) = delete;
+    ~small_vector() {
+        if (first != local) ::operator delete(first);
+    }
+
+    iterator begin() noexcept { return first; }
+    iterator end() noexcept { return first + count; }
+    const_iterator begin() const noexcept { return first; }
+    const_iterator end() const noexcept { return first + count; }
+    size_t size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+    T& operator[](size_t i) noexcept { return first[i]; }
+    const T& operator[](size_t i) const noexcept { return first[i]; }
+    T& front() noexcept { return first[0]; }
+    T& back() noexcept { return first[count - 1]; }
+
+    void reserve(size_t n) {
+        if (n > capacity_) grow_to(n);
+    }
+    void push_back(const T& value) {
+        if (count == capacity_) grow_to(capacity_ * 2);
+        first[count++] = value;
+    }
+    void pop_back() noexcept { --count; }
+    iterator insert(iterator pos, const T& value) {
+        size_t index = static_cast<size_t>(pos - first);
+        if (count == capacity_) grow_to(capacity_ * 2);
+        std::copy_backward(first + index, first + count, first + count + 1);
+        first[index] = value;
+        ++count;
+        return first + index;
+    }
+    iterator erase(iterator pos) noexcept { return erase(pos, pos + 1); }
+    iterator erase(iterator from, iterator to) noexcept {
+        std::copy(to, end(), from);
+        count -= static_cast<size_t>(to - from);
+        return from;
+    }
+    void clear() noexcept { count = 0; }
+};
+
+// Блоков, которые каталог пула держит без обращения к куче
+constexpr size_t local_block_slots = 4;
+
+// Ячейки одного размера: каталог блоков, подсказка текущего блока, списки свободных ячеек.
+// Пул не знает типа объектов, поэтому его делят между собой rebind-варианты аллокатора.
+template <size_t init_size, typename Policy>
+class slot_pool {
+private:
+    // Блок памяти на capacity ячеек
+    // Метаданные блока (эта структура и битовые карты) лежат в отдельной памяти,
+    // в линиях данных — только сами ячейки
+    struct block {
+        unsigned char* data;         // начало ячеек, выровнено на slot_align
+        void* raw;                   // память от поставщика
+        size_t raw_bytes;
+        size_t slot_size;
+        size_t used;
+        size_t capacity;
+        bitmap::word_t* free_slots;  // 1 бит на ячейку, 1 — свободна; в монотонном режиме нет
+        size_t block_id;
+        bool in_partial;             // блок записан в список блоков со свободным местом
+        bool dedicated;              // отдельный блок под один запрос больше обычного блока
+        bool external;               // блок и его ячейки лежат в памяти арены, а не у поставщика
+
+        // Односвязный список освобожденных одиночных ячеек, ссылка хранится в самой ячейке.
+        // Ячейки из списка в free_slots считаются занятыми и отмечены в cached_slots.
+        void* free_list;
+        bitmap::word_t* cached_slots;
+        size_t cached;
+
+        block(size_t slot_size, size_t slot_align, size_t capacity, bool dedicated, size_t block_id);
+        // Блок в готовой памяти: bitmaps — место под две битовые карты, если они нужны
+        block(size_t slot_size, size_t capacity, unsigned char* data, bitmap::word_t* bitmaps, size_t block_id);
+        ~block();
+
+        bool contains(const void* p) const;
+        size_t index_of(const void* p) const;
+        void* allocate(size_t n);
+        // До n одиночных ячеек подряд по словам битовой карты, каждая передается в sink.
+        // Возвращает число выданных ячеек.
+        template <typename Sink>
+        size_t allocate_batch(size_t n, Sink& sink);
+        // Возвращает число ячеек, которые уже были свободны
+        size_t deallocate(void* p, size_t n);
+        void flush_free_list();
+        size_t largest_free_run() const;
+        // Все ячейки снова свободны
+        void reset();
+    };
+
+    // Ссылка свободного списка лежит в первых байтах ячейки. Ячейка передается как void*:
+    // memcpy по указателю на нетривиальный тип дает -Wclass-memaccess.
+    static void* next_free(void* slot);
+    static void set_next_free(void* slot, void* next);
+
+    using counters_type = stats_counters<Policy::collect_stats>;
+    using trace = trace_hook<Policy::record_trace>;
+
+    const size_t slot_size;
+    const size_t slot_align;
+    // Ссылку на следующую свободную ячейку можно хранить в самой ячейке
+    const bool use_free_list;
+
+    // Каталог блоков, отсортированный по адресу data: поиск владельца указателя за O(log N).
+    // Первые блоки записываются внутрь пула, поэтому пул в арене не трогает кучу до переполнения.
+    small_vector<block*, local_block_slots> blocks;
+    // Блоки, в которых при последней проверке было свободное место
+    small_vector<block*, local_block_slots> partial;
+    // Подсказка: блок, из которого последний раз удалось выделить память
+    block* current;
+    // Ёмкость последнего обычного блока, из нее политика роста считает следующую
+    size_t last_capacity;
+    size_t total_blocks;
+    // Обычные блоки без единой занятой ячейки
+    size_t empty_blocks;
+    // Счетчики арены
+    counters_type* counters;
+    // Память арены под первый блок, если она досталась этому пулу
+    void* inline_storage;
+    size_t inline_capacity;
+    bool inline_in_use;
+
+    block* add_block(size_t capacity, bool dedicated = false);
+    block* add_inline_block();
+    void insert_block(block* b);
+    void destroy_block(block* b) noexcept;
+    // Новый обычный блок под n ячеек: память арены, если она свободна и вмещает n, иначе поставщик
+    block* grow(size_t n);
+    void remove_block(block* b) noexcept;
+    block* find_block(const void* p) const;
+    void set_current(block* b);
+    void* allocate_from(block* b, size_t n);
+    void* allocate_slots(size_t n);
+
+public:
+    slot_pool(size_t slot_size, size_t slot_align, counters_type* counters,
+              void* inline_storage = nullptr, size_t inline_bytes = 0);
+    slot_pool(const slot_pool&) = delete;
+    slot_pool& operator=(const slot_pool&) = delete;
+    ~slot_pool();
+
+    void* allocate(size_t n);
+    void deallocate(void* p, size_t n) noexcept;
+    // n одиночных ячеек за один вызов: учет ведется по блокам и словам битовой карты,
+    // а не по ячейкам. sink(void*) получает каждую ячейку. Каждая освобождается
+    // отдельно через deallocate(p, 1).
+    template <typename Sink>
+    void allocate_batch(size_t n, Sink&& sink);
+
+    // Возвращает системе пустые блоки сверх keep_empty, возвращает число освобожденных блоков
+    size_t trim(size_t keep_empty = 0) noexcept;
+    // Освобождает все ячейки разом за O(блоков). Блоки сверх политики удержания
+    // возвращаются системе. Возвращает число освобожденных блоков.
+    size_t reset() noexcept;
+
+    void print_status(std::ostream& os) const;
+    // Добавляет в снимок структуру блоков пула
+    void collect_stats(allocator_stats& stats) const;
+
+    // Геттеры
+    size_t get_slot_size() const { return slot_size; }
+    size_t get_slot_align() const { return slot_align; }
+    void* get_data() const { return current ? current->data : nullptr; }
+    size_t get_used() const;
+    size_t get_capacity() const;
+    size_t get_block_count() const { return blocks.size(); }
+    size_t get_empty_block_count() const { return empty_blocks; }
+};
+
+// Состояние, общее для всех копий аллокатора и его rebind-вариантов.
+// Владеет подпулами для каждого встреченного размера ячейки. Первый подпул и память
+// первого блока лежат в самой арене: контейнер с одним размером ячейки, не переполнивший
+// память арены, обходится одной аллокацией — самой арены.
+template <size_t init_size, typename Policy>
+class arena {
+private:
+    using pool_type = slot_pool<init_size, Policy>;
+
+    stats_counters<Policy::collect_stats> counters;
+    // Достается первому созданному подпулу
+    inline_storage<Policy::inline_bytes> storage;
+    std::optional<pool_type> first_pool;
+    // Подпулы остальных размеров
+    std::vector<std::unique_ptr<pool_type>> pools;
+
+    template <typename F>
+    void for_each_pool(F&& f) {
+        if (first_pool) f(*first_pool);
+        for (const auto& pool : pools) f(*pool);
+    }
+    template <typename F>
+    void for_each_pool(F&& f) const {
+        if (first_pool) f(*first_pool);
+        for (const auto& pool : pools) f(static_cast<const pool_type&>(*pool));
+    }
+
+public:
+    arena() = default;
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    // Подпул для ячеек заданного размера, создается при первом обращении
+    slot_pool<init_size, Policy>& pool_for(size_t slot_size, size_t slot_align);
+    slot_pool<init_size, Policy>* find_pool(size_t slot_size, size_t slot_align) const;
+
+    size_t trim(size_t keep_empty = 0) noexcept;
+    size_t reset() noexcept;
+
+    allocator_stats get_stats() const;
+
+    size_t get_pool_count() const { return pools.size() + (first_pool ? 1 : 0); }
+};
+
+// Реализация блока
+template <size_t init_size, typename Policy>
+slot_pool<init_size, Policy>::block::block(size_t slot_size, size_t slot_align, size_t capacity, bool dedicated, size_t block_id) :
+    data(nullptr), raw(nullptr), raw_bytes(0), slot_size(slot_size), used(0), capacity(capacity), free_slots(nullptr),
+    block_id(block_id), in_partial(false), dedicated(dedicated), external(false), free_list(nullptr), cached_slots(nullptr), cached(0)
+{
+    // Поставщик не гарантирует нужного выравнивания: берем запас и сдвигаем начало
+    size_t padding = slot_align > Policy::provider::alignment ? slot_align - 1 : 0;
+    if (capacity > (static_cast<size_t>(-1) - padding) / slot_size) throw std::bad_alloc();
+    raw_bytes = slot_size * capacity + padding;
+    raw = Policy::provider::allocate(raw_bytes);
+    if (!raw) throw std::bad_alloc();
+    data = reinterpret_cast<unsigned char*>(detail::align_up(reinterpret_cast<std::uintptr_t>(raw), slot_align));
+    // Монотонному блоку хватает счетчика used: ячейки выдаются подряд и не возвращаются
+    if (Policy::monotonic) return;
+
+    // Выделяем битовые карты свободных и закэшированных в free_list ячеек.
+    // Карта кэша начинается с нулей: calloc отдает ее без записи, для больших
+    // блоков — сразу обнуленными страницами системы.
+    size_t words = bitmap::words_for(capacity);
+    free_slots = static_cast<bitmap::word_t*>(calloc(words * 2, sizeof(bitmap::word_t)));
+    if (!free_slots) {
+        Policy::provider::deallocate(raw, raw_bytes);
+        throw std::bad_alloc();
+    }
+    cached_slots = free_slots + words;
+    bitmap::fill(free_slots, capacity);  // Все ячейки свободны
+}
+
+template <size_t init_size, typename Policy>
+slot_pool<init_size, Policy>::block::block(size_t slot_size, size_t capacity, unsigned char* data, bitmap::word_t* bitmaps, size_t block_id) :
+    data(data), raw(nullptr), raw_bytes(0), slot_size(slot_size), used(0), capacity(capacity), free_slots(nullptr),
+    block_id(block_id), in_partial(false), dedicated(false), external(true), free_list(nullptr), cached_slots(nullptr), cached(0)
+{
+    if (Policy::monotonic) return;
+    size_t words = bitmap::words_for(capacity);
+    free_slots = bitmaps;
+    cached_slots = free_slots + words;
+    bitmap::fill(free_slots, capacity);
+    std::memset(cached_slots, 0, sizeof(bitmap::word_t) * words);
+}
+
+template <size_t init_size, typename Policy>
+slot_pool<init_size, Policy>::block::~block()
+{
+    if (external) return;
+    Policy::provider::deallocate(raw, raw_bytes);
+    free(free_slots);
+}
+
+template <size_t init_size, typename Policy>
+bool slot_pool<init_size, Policy>::block::contains(const void* p) const
+{
+    std::less_equal<const void*> le;
+    return le(data, p) && !le(data + slot_size * capacity, p);
+}
+
+template <size_t init_size, typename Policy>
+size_t slot_pool<init_size, Policy>::block::index_of(const void* p) const
+{
+    return (static_cast<const unsigned char*>(p) - data) / slot_size;
+}
+
+template <size_t init_size, typename Policy>
+void* slot_pool<init_size, Policy>::block::allocate(size_t n)
+{
+    // Монотонный режим: сдвиг указателя
+    if (Policy::monotonic) {
+        if (capacity - used < n) return nullptr;
+        void* p = data + used * slot_size;
+        used += n;
+        return p;
+    }
+    // Быстрый путь: одиночная ячейка из списка освобожденных
+    if (n == 1 && free_list) {
+        void* p = free_list;
+        free_list = next_free(p);
+        bitmap::clear_range(cached_slots, index_of(p), 1);
+        --cached;
+        ++used;
+        return p;
+    }
+    if (capacity - used < n) return nullptr;
+
+    // Поиск n последовательных свободных ячеек по словам битовой карты
+    size_t start_index = bitmap::find_run(free_slots, bitmap::words_for(capacity), n);
+    if (start_index == bitmap::npos && cached) {
+        flush_free_list();
+        start_index = bitmap::find_run(free_slots, bitmap::words_for(capacity), n);
+    }
+    if (start_index == bitmap::npos) return nullptr;
+
+    bitmap::clear_range(free_slots, start_index, n);
+    used += n;
+    return data + start_index * slot_size;
+}
+
+template <size_t init_size, typename Policy>
+size_t slot_pool<init_size, Policy>::block::deallocate(void* p, size_t n)
+{
+    size_t index = index_of(p);
+    if (n == 1 && slot_size >= sizeof(void*) && !bitmap::test(free_slots, index) && !bitmap::test(cached_slots, index))
+    {
+        // Быстрый путь: ячейка уходит в голову списка
+        set_next_free(p, free_list);
+        free_list = p;
+        bitmap::set_range(cached_slots, index, 1);
+        ++cached;
+        --used;
+        return 0;
+    }
+    size_t count = n < capacity - index ? n : capacity - index;
+    if (cached && bitmap::count_set(cached_slots, index, count))
+    {
+        flush_free_list();
+    }
+    size_t already_free = bitmap::count_set(free_slots, index, count);
+    if (already_free)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (bitmap::test(free_slots, index + i))
+            {
+                Policy::errors::report({allocation_error::double_free, p, index + i, block_id});
+            }
+        }
+    }
+    // Ячейки были заняты, теперь свободны
+    bitmap::set_range(free_slots, index, count);
+    used -= count - already_free;
+    return already_free;
+}
+
+template <size_t init_size, typename Policy>
+template <typename Sink>
+size_t slot_pool<init_size, Policy>::block::allocate_batch(size_t n, Sink& sink)
+{
+    size_t taken = 0;
+    if (Policy::monotonic) {
+        taken = capacity - used < n ? capacity - used : n;
+        for (size_t i = 0; i < taken; ++i) sink(data + (used + i) * slot_size);
+        used += taken;
+        return taken;
+    }
+
+    // Сначала недавно освобожденные ячейки: они еще в кэше
+    while (taken < n && free_list) {
+        void* p = free_list;
+        free_list = next_free(p);
+        bitmap::clear_range(cached_slots, index_of(p), 1);
+        --cached;
+        ++taken;
+        sink(p);
+    }
+    // Затем свободные биты целыми словами
+    size_t nwords = bitmap::words_for(capacity);
+    for (size_t i = bitmap::find_nonzero_word(free_slots, 0, nwords); taken < n && i < nwords;
+         i = bitmap::find_nonzero_word(free_slots, i + 1, nwords)) {
+        bitmap::word_t w = free_slots[i];
+        while (w && taken < n) {
+            sink(data + (i * bitmap::word_bits + bitmap::ctz(w)) * slot_size);
+            w &= w - 1;
+            ++taken;
+        }
+        free_slots[i] = w;
+    }
+    used += taken;
+    return taken;
+}
+
+// Возвращает закэшированные ячейки в битовую карту, чтобы их увидел поиск серий
+template <size_t init_size, typename Policy>
+void slot_pool<init_size, Policy>::block::flush_free_list()
+{
+    while (free_list) {
+        size_t index = index_of(free_list);
+        bitmap::set_range(free_slots, index, 1);
+        bitmap::clear_range(cached_slots, index, 1);
+        free_list = next_free(free_list);
+    }
+    cached = 0;
+}
+
+// Самая длинная серия свободных ячеек, включая закэшированные в free_list
+template <size_t init_size, typename Policy>
+size_t slot_pool<init_size, Policy>::block::largest_free_run() const
+{
+    if (Policy::monotonic) return capacity - used;
+    size_t best = 0;
+    size_t run = 0;
+    for (size_t i = 0; i < capacity; ++i) {
+        if (bitmap::test(free_slots, i) || bitmap::test(cached_slots, i)) {
+            if (++run > best) best = run;
+        } else {
+            run = 0;
+        }
+    }
+    return best;
+}
+
+template <size_t init_size, typename Policy>
+void slot_pool<init_size, Policy>::block::reset()
+{
+    used = 0;
+    if (Policy::monotonic) return;
+    bitmap::fill(free_slots, capacity);
+    std::memset(cached_slots, 0, sizeof(bitmap::word_t) * bitmap::words_for(capacity));
+    free_list = nullptr;
+    cached = 0;
+}
+
+template <size_t init_size, typename Policy>
+void* slot_pool<init_size, Policy>::next_free(void* slot)
+{
+    void* next;
+    std::memcpy(&next, slot, sizeof(next));
+    return next;
+}
+
+template <size_t init_size, typename Policy>
+void slot_pool<init_size, Policy>::set_next_free(void* slot, void* next)
+{
+    std::memcpy(slot, &next, sizeof(next));
+}
+
+// Реализация пула
+template <size_t init_size, typename Policy>
+slot_pool<init_size, Policy>::slot_pool(size_t slot_size, size_t slot_align, counters_type* counters,
+                                        void* inline_storage, size_t inline_bytes) :
+    slot_size(slot_size), slot_align(slot_align), use_free_list(slot_size >= sizeof(void*)),
+    current(nullptr), last_capacity(0), total_blocks(0), empty_blocks(0), counters(counters),
+    inline_storage(inline_storage), inline_capacity(0), inline_in_use(false)
+{
+    if (!inline_storage) return;
+    // Раскладка памяти арены: структура блока, битовые карты, ячейки.
+    // Берем наибольшую ёмкость, при которой все это помещается.
+    std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(inline_storage);
+    std::uintptr_t maps = align_up(begin + sizeof(block), alignof(bitmap::word_t));
+    for (size_t capacity = inline_bytes / slot_size; capacity > 0; --capacity) {
+        size_t words = Policy::monotonic ? 0 : bitmap::words_for(capacity);
+        std::uintptr_t data = align_up(maps + 2 * words * sizeof(bitmap::word_t), slot_align);
+        if (data + capacity * slot_size <= begin + inline_bytes) {
+            inline_capacity = capacity;
+            break;
+        }
+    }
+}
+
+template <size_t init_size, typename Policy>
+slot_pool<init_size, Policy>::~slot_pool()
+{
+    for (block* b : blocks) {
+        destroy_block(b);
+    }
+}
+
+// Новый блок встает в каталог на место по адресу
+template <size_t init_size, typename Policy>
+typename slot_pool<init_size, Policy>::block* slot_pool<init_size, Policy>::add_block(size_t capacity, bool dedicated)
+{
+    std::unique_ptr<block> b(new block(slot_size, slot_align, capacity, dedicated, ++total_blocks));
+    insert_block(b.get());
+    return b.release();
+}
+
+// Блок в памяти арены; nullptr, если памяти арены не хватает ни на одну ячейку
+template <size_t init_size, typename Policy>
+typename slot_pool<init_size, Policy>::block* slot_pool<init_size, Policy>::add_inline_block()
+{
+    if (!inline_capacity) return nullptr;
+    std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(inline_storage);
+    std::uintptr_t maps = align_up(begin + sizeof(block), alignof(bitmap::word_t));
+    size_t words = Policy::monotonic ? 0 : bitmap::words_for(inline_capacity);
+    std::uintptr_t data = align_up(maps + 2 * words * sizeof(bitmap::word_t), slot_align);
+    block* b = ::new(inline_storage) block(slot_size, inline_capacity, reinterpret_cast<unsigned char*>(data),
+                                           reinterpret_cast<bitmap::word_t*>(maps), ++total_blocks);
+    try {
+        insert_block(b);
+    } catch (...) {
+        b->~block();
+        throw;
+    }
+    inline_in_use = true;
+    return b;
+}
+
+template <size_t init_size, typename Policy>
+void slot_pool<init_size, Policy>::insert_block(block* b)
+{
+    auto pos = std::upper_bound(blocks.begin(), blocks.end(), b->data,
+        [](const void* p, const block* other) { return std::less<const void*>()(p, other->data); });
+    blocks.insert(pos, b);
+    // В partial не больше блоков, чем в каталоге: push_back в deallocate не бросает
+    try {
+        partial.reserve(blocks.size());
+    } catch (...) {
+        blocks.erase(std::find(blocks.begin(), blocks.end(), b));
+        throw;
+    }
+    counters->on_new_block();
+}
+
+// Память арены после освобождения блока снова доступна для grow
+template <size_t init_size, typename Policy>
+void slot_pool<init_size, Policy>::destroy_block(block* b) noexcept
+{
+    if (b->external) {
+        b->~block();
+        inline_in_use = false;
+        return;
+    }
+    delete b;
+}
+
+template <size_t init_size, typename Policy>
+typename slot_pool<init_size, Policy>::block* slot_pool<init_size, Policy>::grow(size_t n)
+{
+    if (!inline_in_use && n <= inline_capacity) return add_inline_block();
+    size_t next_capacity = Policy::growth::next_capacity(init_size, last_capacity);
+    block* b = add_block(next_capacity);
+    last_capacity = next_capacity;
+    return b;
+}
+
+template <size_t init_size, typename Policy>
+void slot_pool<init_size, Policy>::remove_block(block* b) noexcept
+{
+    blocks.erase(std::find(blocks.begin(), blocks.end(), b));
+    if (b->in_partial) {
+        partial.erase(std::find(partial.begin(), partial.end(), b));
+    }
+    if (current == b) current = nullptr;
+    counters->on_release_block();
+    destroy_block(b);
+}
+
+// Прежний текущий блок со свободным местом не должен потеряться
+template <size_t init_size, typename Policy>
+void slot_pool<init_size, Policy>::set_current(block* b)
+{
+    if (current && current != b && !current->in_partial && current->used < current->capacity) {
+        current->in_partial = true;
+        partial.push_back(current);
+    }
+    current = b;
+}
+
+template <size_t init_size, typename Policy>
+typename slot_pool<init_size, Policy>::block* slot_pool<init_size, Policy>::find_block(const void* p) const
+{
+    if (current && current->contains(p)) return current;
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), p,
+        [](const void* ptr, const block* b) { return std::less<const void*>()(ptr, b->data); });
+    if (it == blocks.begin()) return nullptr;
+    block* b = *(it - 1);
+    return b->contains(p) ? b : nullptr;
+}
+
+// Выделение из конкретного блока с учетом того, что блок мог быть пустым
+template <size_t init_size, typename Policy>
+void* slot_pool<init_size, Policy>::allocate_from(block* b, size_t n)
+{
+    bool was_empty = b->used == 0;
+    void* p = b->allocate(n);
+    if (p && was_empty) --empty_blocks;
+    return p;
+}
+
+template <size_t init_size, typename Policy>
+void* slot_pool<init_size, Policy>::allocate(size_t n) {
+    void* p = allocate_slots(n);
+    counters->on_allocate(n * slot_size);
+    trace::on_allocate(p, n, slot_size, slot_align);
+    return p;
+}
+
+template <size_t init_size, typename Policy>
+template <typename Sink>
+void slot_pool<init_size, Policy>::allocate_batch(size_t n, Sink&& sink) {
+    // В трассу пакет попадает поштучно, как при allocate(1)
+    auto traced_sink = [this, &sink](void* p) {
+        trace::on_allocate(p, 1, slot_size, slot_align);
+        sink(p);
+    };
+    size_t done = 0;
+    // Блок из grow еще не учтен среди пустых, как и в allocate_slots
+    bool fresh = false;
+    while (done < n) {
+        if (current) {
+            bool was_empty = current->used == 0 && !fresh;
+            size_t taken = current->allocate_batch(n - done, traced_sink);
+            if (taken && was_empty) --empty_blocks;
+            counters->on_allocate(taken * slot_size, taken);
+            done += taken;
+            if (done == n) break;
+        }
+
+        // Текущий блок исчерпан: следующий из блоков со свободным местом или новый
+        block* next = nullptr;
+        while (!partial.empty() && !next) {
+            block* b = partial.back();
+            partial.pop_back();
+            b->in_partial = false;
+            if (b->used < b->capacity) next = b;
+        }
+        fresh = !next;
+        if (!next) next = grow(1);
+        set_current(next);
+    }
+}
+
+template <size_t init_size, typename Policy>
+void* slot_pool<init_size, Policy>::allocate_slots(size_t n) {
+    // Запрос больше следующего обычного блока получает отдельный блок ровно под себя
+    size_t next_capacity = Policy::growth::next_capacity(init_size, last_capacity);
+    if (n > next_capacity)
+    {
+        return add_block(n, true)->allocate(n);
+    }
+    if (current) {
+        if (void* p = allocate_from(current, n)) return p;
+    }
+
+    // Не нашли места в текущем блоке: пробуем блоки, где освобождалась память
+    for (size_t i = partial.size(); i-- > 0;) {
+        block* b = partial[i];
+        if (b->used == b->capacity) {
+            // Блок снова заполнен, убираем из списка
+            b->in_partial = false;
+            partial[i] = partial.back();
+            partial.pop_back();
+            continue;
+        }
+        if (void* p = allocate_from(b, n)) {
+            set_current(b);
+            return p;
+        }
+    }
+
+    // Места нет нигде, добавляем новый блок
+    set_current(grow(n));
+    return current->allocate(n);
+}
+
+template <size_t init_size, typename Policy>
+void slot_pool<init_size, Policy>::deallocate(void* p, size_t n) noexcept 
+{
+    trace::on_deallocate(p, n, slot_size, slot_align);
+    if (Policy::monotonic) {
+        counters->on_deallocate(0, 0);
+        return;
+    }
+    block* b = find_block(p);
+    if (!b) {
+        Policy::errors::report({allocation_error::foreign_pointer, p, 0, 0});
+        counters->on_foreign_free();
+        return;
+    }
+
+    size_t used_before = b->used;
+    size_t double_freed = b->deallocate(p, n);
+    counters->on_deallocate((used_before - b->used) * slot_size, double_freed);
+    if (b->dedicated) {
+        // Отдельный блок больше никому не нужен
+        if (b->used == 0) remove_block(b);
+        return;
+    }
+    if (b->used == 0) {
+        ++empty_blocks;
+        // Лишний пустой блок возвращается системе, текущий остается горячим
+        if (empty_blocks > Policy::retention::max_empty_blocks && b != current) {
+            --empty_blocks;
+            remove_block(b);
+            return;
+        }
+    }
+    if (!b->in_partial && b != current) {
+        b->in_partial = true;
+        partial.push_back(b);
+    }
+}
+
+template <size_t init_size, typename Policy>
+size_t slot_pool<init_size, Policy>::trim(size_t keep_empty) noexcept
+{
+    size_t kept = 0;
+    size_t released = 0;
+    for (size_t i = blocks.size(); i-- > 0;) {
+        block* b = blocks[i];
+        if (b->used != 0 || b->dedicated) continue;
+        if (kept < keep_empty) {
+            ++kept;
+            continue;
+        }
+        remove_block(b);
+        ++released;
+    }
+    empty_blocks = kept;
+    return released;
+}
+
+template <size_t init_size, typename Policy>
+size_t slot_pool<init_size, Policy>::reset() noexcept
+{
+    size_t kept = 0;
+    size_t released = 0;
+    size_t live_bytes = 0;
+    auto out = blocks.begin();
+    for (block* b : blocks) {
+        live_bytes += b->used * slot_size;
+        if (b->dedicated || kept >= Policy::retention::max_empty_blocks) {
+            counters->on_release_block();
+            destroy_block(b);
+            ++released;
+            continue;
+        }
+        b->reset();
+        b->in_partial = false;
+        ++kept;
+        *out++ = b;
+    }
+    blocks.erase(out, blocks.end());
+    partial.clear();
+    current = blocks.empty() ? nullptr : blocks.front();
+    if (blocks.empty()) last_capacity = 0;
+    empty_blocks = kept;
+    counters->on_reset(live_bytes);
+    return released;
+}
+
+template <size_t init_size, typename Policy>
+size_t slot_pool<init_size, Policy>::get_used() const {
+    size_t result = 0;
+    for (const block* b : blocks) result += b->used;
+    return result;
+}
+
+template <size_t init_size, typename Policy>
+size_t slot_pool<init_size, Policy>::get_capacity() const {
+    size_t result = 0;
+    for (const block* b : blocks) result += b->capacity;
+    return result;
+}
+
+template <size_t init_size, typename Policy>
+void slot_pool<init_size, Policy>::print_status(std::ostream& os) const {
+    for (const block* b : blocks) {
+        os << "Блок #" << b->block_id << " (ячейки по " << slot_size << " байт): "
+                  << "использовано " << b->used << "/" << b->capacity 
+                  << " (" << (b->used * 100 / b->capacity) << "%), "
+                  << "адрес начала: " << static_cast<const void*>(b->data) 
+                  << (b == current ? ", текущий" : "")
+                  << (b->dedicated ? ", отдельный" : "") << "\n";
+    }
+}
+
+template <size_t init_size, typename Policy>
+void slot_pool<init_size, Policy>::collect_stats(allocator_stats& stats) const {
+    for (const block* b : blocks) {
+        size_t free_slots = b->capacity - b->used;
+        size_t largest = b->largest_free_run() * slot_size;
+        stats.block_count += 1;
+        stats.dedicated_block_count += b->dedicated;
+        stats.empty_block_count += b->used == 0 && !b->dedicated;
+        stats.live_bytes += b->used * slot_size;
+        stats.capacity_bytes += b->capacity * slot_size;
+        stats.free_bytes += free_slots * slot_size;
+        if (largest > stats.largest_free_run_bytes) stats.largest_free_run_bytes = largest;
+        stats.fill_histogram[b->used * (allocator_stats::histogram_buckets - 1) / b->capacity] += 1;
+    }
+}
+
+// Реализация арены
+template <size_t init_size, typename Policy>
+slot_pool<init_size, Policy>& arena<init_size, Policy>::pool_for(size_t slot_size, size_t slot_align)
+{
+    if (pool_type* pool = find_pool(slot_size, slot_align)) {
+        return *pool;
+    }
+    if (!first_pool) {
+        return first_pool.emplace(slot_size, slot_align, &counters, storage.data(), storage.size());
+    }
+    std::unique_ptr<pool_type> pool(new pool_type(slot_size, slot_align, &counters));
+    pools.push_back(std::move(pool));
+    return *pools.back();
+}
+
+template <size_t init_size, typename Policy>
+slot_pool<init_size, Policy>* arena<init_size, Policy>::find_pool(size_t slot_size, size_t slot_align) const
+{
+    const pool_type* found = nullptr;
+    for_each_pool([&](const pool_type& pool) {
+        if (!found && pool.get_slot_size() == slot_size && pool.get_slot_align() == slot_align) found = &pool;
+    });
+    // Подпул не часть логического состояния арены: константная арена раздает изменяемые подпулы
+    return const_cast<pool_type*>(found);
+}
+
+template <size_t init_size, typename Policy>
+size_t arena<init_size, Policy>::trim(size_t keep_empty) noexcept
+{
+    size_t released = 0;
+    for_each_pool([&](pool_type& pool) { released += pool.trim(keep_empty); });
+    return released;
+}
+
+template <size_t init_size, typename Policy>
+size_t arena<init_size, Policy>::reset() noexcept
+{
+    size_t released = 0;
+    for_each_pool([&](pool_type& pool) { released += pool.reset(); });
+    return released;
+}
+
+template <size_t init_size, typename Policy>
+allocator_stats arena<init_size, Policy>::get_stats() const
+{
+    allocator_stats stats;
+    stats.counters_enabled = Policy::collect_stats;
+    stats.init_size = init_size;
+    stats.pool_count = get_pool_count();
+    for_each_pool([&](const pool_type& pool) { pool.collect_stats(stats); });
+    if (stats.free_bytes) {
+        stats.fragmentation = 1.0 - static_cast<double>(stats.largest_free_run_bytes) / stats.free_bytes;
+    }
+    counters.fill(stats);
+    return stats;
+}
+
+}  // namespace detail
 
 // АЛЛОКАТОР 
-template <typename T, size_t init_size = 10>
+// Легкий дескриптор общей арены: копии и rebind-варианты ссылаются на одну арену,
+// поэтому память, выделенная через любой из них, освобождается через любой другой.
+// Арена создается лениво: при первом выделении или первом копировании, поэтому
+// аллокатор по умолчанию и пустой контейнер на нем ничего не стоят. Копирование
+// аллокатора без арены заводит ее у источника, чтобы копии делили одну арену, и потому
+// может бросить bad_alloc; одновременно копировать один аллокатор из разных потоков нельзя.
+// Перемещение арену не создает и не бросает, на нем держатся noexcept-перемещения контейнеров.
+template <typename T, size_t init_size = 10, typename Policy = default_allocator_policy>
 class allocator {
 private:
-    T* data;
-    allocator* next_block;
-    bool block_allocated;
-    size_t used;
-    size_t capacity;
-    bool* free_slots;
-    size_t block_id;
-    static size_t total_blocks;
+    template <typename U, size_t N, typename P>
+    friend class allocator;
+
+    using arena_type = detail::arena<init_size, Policy>;
+    using pool_type = detail::slot_pool<init_size, Policy>;
+
+    // Шаг и выравнивание ячеек для T по политике раскладки
+    static constexpr size_t slot_size = Policy::layout::slot_size(sizeof(T), alignof(T));
+    static constexpr size_t slot_align = Policy::layout::slot_align(alignof(T));
+
+    // Ячеек под массив из n объектов: массив лежит вплотную с шагом sizeof(T),
+    // поэтому при ячейках шире sizeof(T) их нужно меньше n
+    static constexpr size_t slots_for(size_t n) noexcept {
+        if constexpr (slot_size == sizeof(T)) {
+            return n;
+        } else {
+            return n * sizeof(T) / slot_size + (n * sizeof(T) % slot_size != 0);
+        }
+    }
+
+    // Пустой до первого выделения или копирования
+    mutable std::shared_ptr<arena_type> shared_arena;
+    // Подпул для ячеек sizeof(T), берется из арены при первом выделении
+    pool_type* pool;
+
+    // Арена, созданная при необходимости
+    const std::shared_ptr<arena_type>& get_arena() const;
+    pool_type& get_pool();
+    const pool_type* find_pool() const;
+    
+public:
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    // Память принадлежит арене, поэтому аллокатор переезжает вместе с элементами контейнера
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+    // Освобождение отдельных объектов можно пропускать: память вернет reset() или арена
+    using bulk_release = std::integral_constant<bool, Policy::monotonic>;
+    
+    template<typename U>
+    struct rebind {
+        using other = allocator<U, init_size, Policy>;
+    };
+    
+    allocator() noexcept;
+    // Копия делит арену с источником, при необходимости арена создается (может бросить bad_alloc)
+    allocator(const allocator& other);
+    template <typename U>
+    allocator(const allocator<U, init_size, Policy>&);
+    allocator& operator=(const allocator& other);
+    // Перемещение забирает арену, если она есть, но источник остается на ней же: std::deque
+    // освобождает через перемещенный аллокатор память, выделенную новым. Перемещенный
+    // аллокатор без арены остается без арены — ни он, ни источник еще ничего не выделяли.
+    allocator(allocator&& other) noexcept;
+    template <typename U>
+    allocator(allocator<U, init_size, Policy>&& other) noexcept;
+    allocator& operator=(allocator&& other) noexcept;
+    
+    T* allocate(size_t n);
+    void deallocate(T* p, size_t n) noexcept;
+    // n отдельных объектов за один вызов, out[i] освобождается через deallocate(out[i], 1).
+    // При нехватке памяти уже выданные объекты возвращаются и бросается bad_alloc.
+    void allocate_batch(T** out, size_t n);
+    
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args);
+    
+    template<typename U>
+    void destroy(U* p) noexcept;
+    
+    size_t max_size() const noexcept;
+    
+    template<typename U>
+    bool operator==(const allocator<U, init_size, Policy>&) const noexcept;
+    
+    template<typename U>
+    bool operator!=(const allocator<U, init_size, Policy>& other) const noexcept;
+    
+    // Возвращает системе пустые блоки всех подпулов арены сверх keep_empty на подпул
+    size_t trim(size_t keep_empty = 0) noexcept { return shared_arena ? shared_arena->trim(keep_empty) : 0; }
+    // Освобождает всю память арены разом. Указатели, полученные через любую копию
+    // аллокатора, становятся недействительными: контейнеры на арене должны быть пусты
+    // или больше не использоваться.
+    size_t reset() noexcept { return shared_arena ? shared_arena->reset() : 0; }
+
+    // Снимок статистики всей арены: все подпулы, все блоки
+    allocator_stats get_stats() const;
+    
+    void print_status(std::ostream& os) const;
+    
+    // Геттеры: состояние подпула для ячеек типа T
+    T* get_data() const;
+    size_t get_used() const;
+    size_t get_capacity() const;
+    size_t get_block_count() const;
+    size_t get_empty_block_count() const;
+    // Сколько разных размеров ячеек обслуживает общая арена
+    size_t get_pool_count() const { return shared_arena ? shared_arena->get_pool_count() : 0; }
+};
+
+// Реализация аллокатора
+template <typename T, size_t init_size, typename Policy>
+allocator<T, init_size, Policy>::allocator() noexcept :
+    pool(nullptr)
+{
+}
+
+template <typename T, size_t init_size, typename Policy>
+allocator<T, init_size, Policy>::allocator(const allocator& other) :
+    shared_arena(other.get_arena()), pool(other.pool)
+{
+}
+
+template <typename T, size_t init_size, typename Policy>
+template <typename U>
+allocator<T, init_size, Policy>::allocator(const allocator<U, init_size, Policy>& other) :
+    shared_arena(other.get_arena()), pool(nullptr)
+{
+}
+
+template <typename T, size_t init_size, typename Policy>
+allocator<T, init_size, Policy>& allocator<T, init_size, Policy>::operator=(const allocator& other)
+{
+    shared_arena = other.get_arena();
+    pool = other.pool;
+    return *this;
+}
+
+template <typename T, size_t init_size, typename Policy>
+allocator<T, init_size, Policy>::allocator(allocator&& other) noexcept :
+    shared_arena(other.shared_arena), pool(other.pool)
+{
+}
+
+template <typename T, size_t init_size, typename Policy>
+template <typename U>
+allocator<T, init_size, Policy>::allocator(allocator<U, init_size, Policy>&& other) noexcept :
+    shared_arena(other.shared_arena), pool(nullptr)
+{
+}
+
+template <typename T, size_t init_size, typename Policy>
+allocator<T, init_size, Policy>& allocator<T, init_size, Policy>::operator=(allocator&& other) noexcept
+{
+    shared_arena = other.shared_arena;
+    pool = other.pool;
+    return *this;
+}
+
+template <typename T, size_t init_size, typename Policy>
+const std::shared_ptr<typename allocator<T, init_size, Policy>::arena_type>& allocator<T, init_size, Policy>::get_arena() const
+{
+    if (!shared_arena) shared_arena = std::make_shared<arena_type>();
+    return shared_arena;
+}
+
+template <typename T, size_t init_size, typename Policy>
+typename allocator<T, init_size, Policy>::pool_type& allocator<T, init_size, Policy>::get_pool()
+{
+    if (!pool) pool = &get_arena()->pool_for(slot_size, slot_align);
+    return *pool;
+}
+
+template <typename T, size_t init_size, typename Policy>
+const typename allocator<T, init_size, Policy>::pool_type* allocator<T, init_size, Policy>::find_pool() const
+{
+    if (pool || !shared_arena) return pool;
+    return shared_arena->find_pool(slot_size, slot_align);
+}
+
+// Без арены структура пуста, но настройки видны
+template <typename T, size_t init_size, typename Policy>
+allocator_stats allocator<T, init_size, Policy>::get_stats() const
+{
+    if (shared_arena) return shared_arena->get_stats();
+    allocator_stats stats;
+    stats.counters_enabled = Policy::collect_stats;
+    stats.init_size = init_size;
+    return stats;
+}
+
+template <typename T, size_t init_size, typename Policy>
+T* allocator<T, init_size, Policy>::allocate(size_t n) {
+    if (n == 0) { return nullptr; }
+    if (n > max_size()) throw std::bad_alloc();
+    return static_cast<T*>(get_pool().allocate(slots_for(n)));
+}
+
+template <typename T, size_t init_size, typename Policy>
+void allocator<T, init_size, Policy>::deallocate(T* p, size_t n) noexcept 
+{
+    if (!p || n == 0) return;
+    // Подпул не создается: без арены или без подпула для ячеек T аллокатор этот указатель не выделял
+    if (!pool && shared_arena) pool = shared_arena->find_pool(slot_size, slot_align);
+    if (!pool) {
+        Policy::errors::report({allocation_error::foreign_pointer, p, 0, 0});
+        return;
+    }
+    pool->deallocate(p, slots_for(n));
+}
+
+template <typename T, size_t init_size, typename Policy>
+void allocator<T, init_size, Policy>::allocate_batch(T** out, size_t n) {
+    size_t done = 0;
+    try {
+        get_pool().allocate_batch(n, [out, &done](void* p) { out[done++] = static_cast<T*>(p); });
+    } catch (...) {
+        for (size_t i = 0; i < done; ++i) deallocate(out[i], 1);
+        throw;
+    }
+}
+
+template <typename T, size_t init_size, typename Policy>
+template <typename U, typename... Args>
+void allocator<T, init_size, Policy>::construct(U* p, Args&&... args) {
+    ::new((void*)p) U(std::forward<Args>(args)...);
+}
+
+template <typename T, size_t init_size, typename Policy>    
+template<typename U>
+void allocator<T, init_size, Policy>::destroy(U* p) noexcept {
+    p->~U();
+}
+
+template <typename T, size_t init_size, typename Policy> 
+size_t allocator<T, init_size, Policy>::max_size() const noexcept {
+    return static_cast<size_t>(-1) / sizeof(T);
+}
+
+// Равны аллокаторы, которые делят одну арену
+template <typename T, size_t init_size, typename Policy>     
+template<typename U>
+bool allocator<T, init_size, Policy>::operator==(const allocator<U, init_size, Policy>& other) const noexcept {
+    // Аллокатор без арены равен только самому себе: у другого может появиться своя арена
+    if (!shared_arena || !other.shared_arena) {
+        return static_cast<const void*>(this) == static_cast<const void*>(&other);
+    }
+    return shared_arena == other.shared_arena;
+}
+
+template <typename T, size_t init_size, typename Policy>    
+template<typename U>
+bool allocator<T, init_size, Policy>::operator!=(const allocator<U, init_size, Policy>& other) const noexcept {
+    return !(*this == other);
+}
+
+template <typename T, size_t init_size, typename Policy>
+T* allocator<T, init_size, Policy>::get_data() const {
+    const pool_type* p = find_pool();
+    return p ? static_cast<T*>(p->get_data()) : nullptr;
+}
+
+template <typename T, size_t init_size, typename Policy>
+size_t allocator<T, init_size, Policy>::get_used() const {
+    const pool_type* p = find_pool();
+    return p ? p->get_used() : 0;
+}
+
+template <typename T, size_t init_size, typename Policy>
+size_t allocator<T, init_size, Policy>::get_capacity() const {
+    const pool_type* p = find_pool();
+    return p ? p->get_capacity() : 0;
+}
+
+template <typename T, size_t init_size, typename Policy>
+size_t allocator<T, init_size, Policy>::get_block_count() const {
+    const pool_type* p = find_pool();
+    return p ? p->get_block_count() : 0;
+}
+
+template <typename T, size_t init_size, typename Policy>
+size_t allocator<T, init_size, Policy>::get_empty_block_count() const {
+    const pool_type* p = find_pool();
+    return p ? p->get_empty_block_count() : 0;
+}
+
+template <typename T, size_t init_size, typename Policy> 
+void allocator<T, init_size, Policy>::print_status(std::ostream& os) const {
+    if (const pool_type* p = find_pool()) {
+        p->print_status(os);
+    } else {
+        os << "Блоков нет\n";
+    }
+}
+
+// Оператор вывода
+template <typename T, size_t N, typename Policy>
+std::ostream& operator<<(std::ostream& os, const allocator<T, N, Policy>& alloc) {
+    os << "allocator[блок #" << reinterpret_cast<const void*>(&alloc) 
+       << ", data=" << alloc.get_data() 
+       << ", used=" << alloc.get_used() 
+       << "/" << alloc.get_capacity() 
+       << ", blocks=" << alloc.get_block_count() << "]";
+    return os;
+}
+
+template <typename T, size_t init_size = 10>
+using monotonic_allocator = allocator<T, init_size, monotonic_allocator_policy>;
+
+namespace detail {
+    // Аллокатор объявляет bulk_release: поштучное освобождение можно пропустить
+    template <typename Alloc, typename = void>
+    struct has_bulk_release : std::false_type {};
+
+    template <typename Alloc>
+    struct has_bulk_release<Alloc, std::void_t<typename Alloc::bulk_release>> : Alloc::bulk_release {};
+
+    // Аллокатор умеет выдать несколько объектов одним вызовом allocate_batch
+    template <typename Alloc, typename = void>
+    struct has_batch_allocate : std::false_type {};
+
+    template <typename Alloc>
+    struct has_batch_allocate<Alloc, std::void_t<decltype(std::declval<Alloc&>().allocate_batch(
+        std::declval<typename Alloc::value_type**>(), size_t()))>> : std::true_type {};
+
+    // n отдельных объектов: пачкой, если аллокатор это умеет, иначе по одному
+    template <typename Alloc>
+    void allocate_each(Alloc& alloc, typename Alloc::value_type** out, size_t n) {
+        if constexpr (has_batch_allocate<Alloc>::value) {
+            alloc.allocate_batch(out, n);
+        } else {
+            size_t done = 0;
+            try {
+                for (; done < n; ++done) out[done] = std::allocator_traits<Alloc>::allocate(alloc, 1);
+            } catch (...) {
+                while (done) std::allocator_traits<Alloc>::deallocate(alloc, out[--done], 1);
+                throw;
+            }
+        }
+    }
+
+    // Отсекает целые типы в конструкторе из диапазона
+    template <typename It>
+    using iterator_category_t = typename std::iterator_traits<It>::iterator_category;
+
+    template <typename It>
+    constexpr bool is_forward_iterator =
+        std::is_base_of<std::forward_iterator_tag, iterator_category_t<It>>::value;
+
+    // Узлов, выделяемых за один вызов при добавлении диапазона
+    constexpr size_t node_batch_size = 64;
+}
+
+// РАСКЛАДКА УЗЛОВ MYCONTAINER
+// Один элемент в узле
+struct node_layout {};
+
+// Развернутый список: до K элементов в узле, K == 0 — подобрать по кэш-линии
+template <size_t K = 0>
+struct unrolled_layout {};
+
+// Упорядоченный список с индексом skip-list: элементы по возрастанию Compare,
+// поиск и вставка на место за O(log n) в среднем
+template <typename Compare = std::less<>>
+struct ordered_layout {};
+
+namespace detail {
+    // Начальное состояние генератора высот skip-list: одинаковые вставки дают одинаковый индекс
+    constexpr std::uint64_t skip_list_seed = 0x9E3779B97F4A7C15ULL;
+}
+
+// МОЙ КОНТЕЙНЕР 
+template <typename T, typename Alloc = std::allocator<T>, typename Layout = node_layout>
+class MyContainer {
+private:
+    struct Node {
+        T value;
+        Node* next;
+        // Значение строится прямо в узле из аргументов emplace
+        template <typename... Args>
+        explicit Node(std::in_place_t, Args&&... args);
+    };
     
+    // Узлы выделяются через allocator_traits: подходят и аллокаторы без rebind,
+    // например std::pmr::polymorphic_allocator
+    using node_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+    using node_traits = std::allocator_traits<node_allocator>;
+
+    Node* head;
+    Node* tail;
+    size_t count;
+    node_allocator alloc;
+
 public:
-    using value_type = T;
-    using pointer = T*;
-    using const_pointer = const T*;
-    using reference = T&;
-    using const_reference = const T&;
-    using size_type = std::size_t;
-    using difference_type = std::ptrdiff_t;
-    
-    template<typename U>
-    struct rebind {
-        using other = allocator<U, init_size>;
+    // ИТЕРАТОР
+    // Помнит предыдущий узел, поэтому insert и erase по итератору работают за O(1)
+    class iterator {
+        
+    private:
+        Node* current;
+        Node* previous;
+        
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        iterator(Node* node = nullptr, Node* previous = nullptr) : current(node), previous(previous) {}
+        
+        T& operator*() { return current->value; }
+        T* operator->() { return &current->value; }
+        
+        iterator& operator++() {  // ++it
+            previous = current;
+            current = current->next;
+            return *this;
+        }
+        
+        iterator operator++(int) {  // it++
+            iterator old = *this;
+            ++*this;
+            return old;
+        }
+        
+        bool operator==(const iterator& other) const { return current == other.current; }
+        bool operator!=(const iterator& other) const { return current != other.current; }
+        
+        // Для доступа к узлам внутри insert и erase
+        Node* get_node() { return current; }
+        Node* get_previous() { return previous; }
     };
     
-    allocator();
-    template <typename U>
-    allocator(const allocator<U, init_size>&);
-    ~allocator();
-    
-    T* allocate(size_t n);
-    void deallocate(T* p, size_t n) noexcept;
+public:
+    MyContainer();
+    explicit MyContainer(const Alloc& alloc);
+    // Копия получает аллокатор через select_on_container_copy_construction
+    MyContainer(const MyContainer& other);
+    MyContainer(const MyContainer& other, const Alloc& alloc);
+    // Перемещение забирает узлы целиком за O(1)
+    MyContainer(MyContainer&& other) noexcept;
+    // Элементы диапазона добавляются через append
+    MyContainer(std::initializer_list<T> values, const Alloc& alloc = Alloc());
+    template <typename InputIt, typename = detail::iterator_category_t<InputIt>>
+    MyContainer(InputIt first, InputIt last, const Alloc& alloc = Alloc());
+    ~MyContainer();
     
-    template <typename U, typename... Args>
-    void construct(U* p, Args&&... args);
+    MyContainer& operator=(const MyContainer& other);
+    MyContainer& operator=(MyContainer&& other)
+        noexcept(node_traits::propagate_on_container_move_assignment::value || node_traits::is_always_equal::value);
     
-    template<typename U>
-    void destroy(U* p) noexcept;
+    void add(const T& value);
+    void add(T&& value);
+    template <typename... Args>
+    T& emplace_back(Args&&... args);
+    // Добавление диапазона в конец. Для прямых итераторов узлы выделяются пачками
+    // по detail::node_batch_size и подвешиваются к хвосту одной цепочкой.
+    template <typename InputIt>
+    void append(InputIt first, InputIt last);
+    template <typename InputIt>
+    void assign(InputIt first, InputIt last);
+    void assign(std::initializer_list<T> values);
+    void clear();
+    void print(std::ostream& os) const;
+    size_t size() const;
+    bool empty() const;
+    Alloc get_allocator() const { return Alloc(alloc); }
+
+    // Методы для итераторов
+    iterator begin() { return iterator(head); }
+    iterator end() { return iterator(nullptr, tail); }
     
-    size_t max_size() const noexcept;
+    // Вставка перед pos за O(1). Итераторы на pos после вставки недействительны.
+    iterator insert(iterator pos, const T& value);
+    iterator insert(iterator pos, T&& value);
+    template <typename... Args>
+    iterator emplace(iterator pos, Args&&... args);
+    // Удаление элемента pos за O(1), возвращает итератор на следующий.
+    // Итераторы на pos и на следующий элемент недействительны.
+    iterator erase(iterator pos);
+
+    // Разбиение на parts диапазонов почти равной длины за один проход: parts + 1 границ,
+    // диапазон i — [bounds[i], bounds[i + 1]). Границы живут, пока контейнер не изменится,
+    // и могут переиспользоваться параллельными алгоритмами вместо нового прохода.
+    std::vector<iterator> split_points(size_t parts);
+
+private:
+    // метод для поиска предыдущего узла
+    Node* find_previous(Node* target);
+    // Предыдущий узел из итератора; устаревший итератор обходится поиском от head
+    Node* previous_of(iterator pos);
+    // Забирает узлы other, other остается пустым
+    void steal(MyContainer& other) noexcept;
+    void append_copy(const MyContainer& other);
+    // Подвешивает n готовых узлов к хвосту в заданном порядке
+    void link_back(Node** nodes, size_t n) noexcept;
+};
+
+// Реализация MyContainer
+template <typename T, typename Alloc, typename Layout>
+template <typename... Args>
+MyContainer<T, Alloc, Layout>::Node::Node(std::in_place_t, Args&&... args) :
+    value(std::forward<Args>(args)...), next(nullptr) {}
+
+template <typename T, typename Alloc, typename Layout>
+MyContainer<T, Alloc, Layout>::MyContainer() : head(nullptr), tail(nullptr), count(0) {}
+
+template <typename T, typename Alloc, typename Layout>
+MyContainer<T, Alloc, Layout>::MyContainer(const Alloc& alloc) : head(nullptr), tail(nullptr), count(0), alloc(alloc) {}
+
+template <typename T, typename Alloc, typename Layout>
+MyContainer<T, Alloc, Layout>::MyContainer(const MyContainer& other) :
+    head(nullptr), tail(nullptr), count(0),
+    alloc(node_traits::select_on_container_copy_construction(other.alloc))
+{
+    append_copy(other);
+}
+
+template <typename T, typename Alloc, typename Layout>
+MyContainer<T, Alloc, Layout>::MyContainer(const MyContainer& other, const Alloc& alloc) :
+    head(nullptr), tail(nullptr), count(0), alloc(alloc)
+{
+    append_copy(other);
+}
+
+template <typename T, typename Alloc, typename Layout>
+MyContainer<T, Alloc, Layout>::MyContainer(MyContainer&& other) noexcept :
+    head(nullptr), tail(nullptr), count(0), alloc(std::move(other.alloc))
+{
+    steal(other);
+}
+
+template <typename T, typename Alloc, typename Layout>
+MyContainer<T, Alloc, Layout>::MyContainer(std::initializer_list<T> values, const Alloc& alloc) :
+    MyContainer(alloc)
+{
+    append(values.begin(), values.end());
+}
+
+template <typename T, typename Alloc, typename Layout>
+template <typename InputIt, typename>
+MyContainer<T, Alloc, Layout>::MyContainer(InputIt first, InputIt last, const Alloc& alloc) :
+    MyContainer(alloc)
+{
+    append(first, last);
+}
+
+template <typename T, typename Alloc, typename Layout>
+MyContainer<T, Alloc, Layout>::~MyContainer() {
+    clear();
+}
+
+template <typename T, typename Alloc, typename Layout>
+MyContainer<T, Alloc, Layout>& MyContainer<T, Alloc, Layout>::operator=(const MyContainer& other) {
+    if (this == &other) return *this;
+    clear();
+    if (node_traits::propagate_on_container_copy_assignment::value) {
+        alloc = other.alloc;
+    }
+    append_copy(other);
+    return *this;
+}
+
+// Узлы можно забрать, если память other освобождается нашим аллокатором,
+// иначе элементы перемещаются по одному в новые узлы
+template <typename T, typename Alloc, typename Layout>
+MyContainer<T, Alloc, Layout>& MyContainer<T, Alloc, Layout>::operator=(MyContainer&& other)
+    noexcept(node_traits::propagate_on_container_move_assignment::value || node_traits::is_always_equal::value)
+{
+    if (this == &other) return *this;
+    clear();
+    if constexpr (node_traits::propagate_on_container_move_assignment::value) {
+        alloc = std::move(other.alloc);
+        steal(other);
+    } else {
+        if (alloc == other.alloc) {
+            steal(other);
+        } else {
+            for (Node* current = other.head; current; current = current->next) {
+                emplace_back(std::move(current->value));
+            }
+            other.clear();
+        }
+    }
+    return *this;
+}
+
+template <typename T, typename Alloc, typename Layout>
+void MyContainer<T, Alloc, Layout>::steal(MyContainer& other) noexcept {
+    head = other.head;
+    tail = other.tail;
+    count = other.count;
+    other.head = other.tail = nullptr;
+    other.count = 0;
+}
+
+template <typename T, typename Alloc, typename Layout>
+void MyContainer<T, Alloc, Layout>::append_copy(const MyContainer& other) {
+    try {
+        for (const Node* current = other.head; current; current = current->next) {
+            emplace_back(current->value);
+        }
+    } catch (...) {
+        clear();
+        throw;
+    }
+}
+
+template <typename T, typename Alloc, typename Layout>
+template <typename InputIt>
+void MyContainer<T, Alloc, Layout>::append(InputIt first, InputIt last) {
+    if constexpr (!detail::is_forward_iterator<InputIt>) {
+        // Длина диапазона заранее неизвестна
+        for (; first != last; ++first) emplace_back(*first);
+    } else {
+        size_t remaining = static_cast<size_t>(std::distance(first, last));
+        Node* batch[detail::node_batch_size];
+        while (remaining) {
+            size_t n = remaining < detail::node_batch_size ? remaining : detail::node_batch_size;
+            detail::allocate_each(alloc, batch, n);
+            size_t built = 0;
+            try {
+                for (; built < n; ++built, ++first) {
+                    node_traits::construct(alloc, batch[built], std::in_place, *first);
+                }
+            } catch (...) {
+                // Построенные узлы остаются в контейнере, невостребованная память возвращается
+                for (size_t i = built; i < n; ++i) node_traits::deallocate(alloc, batch[i], 1);
+                link_back(batch, built);
+                throw;
+            }
+            link_back(batch, n);
+            remaining -= n;
+        }
+    }
+}
+
+template <typename T, typename Alloc, typename Layout>
+template <typename InputIt>
+void MyContainer<T, Alloc, Layout>::assign(InputIt first, InputIt last) {
+    clear();
+    append(first, last);
+}
+
+template <typename T, typename Alloc, typename Layout>
+void MyContainer<T, Alloc, Layout>::assign(std::initializer_list<T> values) {
+    assign(values.begin(), values.end());
+}
+
+template <typename T, typename Alloc, typename Layout>
+void MyContainer<T, Alloc, Layout>::link_back(Node** nodes, size_t n) noexcept {
+    if (!n) return;
+    for (size_t i = 0; i + 1 < n; ++i) nodes[i]->next = nodes[i + 1];
+    nodes[n - 1]->next = nullptr;
+    (tail ? tail->next : head) = nodes[0];
+    tail = nodes[n - 1];
+    count += n;
+}
+
+template <typename T, typename Alloc, typename Layout>
+void MyContainer<T, Alloc, Layout>::add(const T& value) {
+    emplace(end(), value);  // Просто вставка в конец
+}
+
+template <typename T, typename Alloc, typename Layout>
+void MyContainer<T, Alloc, Layout>::add(T&& value) {
+    emplace(end(), std::move(value));
+}
+
+template <typename T, typename Alloc, typename Layout>
+template <typename... Args>
+T& MyContainer<T, Alloc, Layout>::emplace_back(Args&&... args) {
+    return *emplace(end(), std::forward<Args>(args)...);
+}
+
+template <typename T, typename Alloc, typename Layout>
+typename MyContainer<T, Alloc, Layout>::iterator 
+MyContainer<T, Alloc, Layout>::insert(iterator pos, const T& value) {
+    return emplace(pos, value);
+}
+
+template <typename T, typename Alloc, typename Layout>
+typename MyContainer<T, Alloc, Layout>::iterator 
+MyContainer<T, Alloc, Layout>::insert(iterator pos, T&& value) {
+    return emplace(pos, std::move(value));
+}
+
+// Метод emplace
+template <typename T, typename Alloc, typename Layout>
+template <typename... Args>
+typename MyContainer<T, Alloc, Layout>::iterator 
+MyContainer<T, Alloc, Layout>::emplace(iterator pos, Args&&... args) {
+    // Создаем новый узел
+    Node* new_node = node_traits::allocate(alloc, 1);
+    try {
+        node_traits::construct(alloc, new_node, std::in_place, std::forward<Args>(args)...);
+    } catch (...) {
+        node_traits::deallocate(alloc, new_node, 1);
+        throw;
+    }
     
-    template<typename U>
-    bool operator==(const allocator<U, init_size>&) const noexcept;
+    // Новый узел встает между предыдущим и pos
+    Node* prev = previous_of(pos);
+    new_node->next = pos.get_node();
+    if (prev) {
+        prev->next = new_node;
+    } else {
+        head = new_node;
+    }
+    if (!new_node->next) tail = new_node;
     
-    template<typename U>
-    bool operator!=(const allocator<U, init_size>& other) const noexcept;
+    count++;
+    return iterator(new_node, prev);
+}
+
+template <typename T, typename Alloc, typename Layout>
+typename MyContainer<T, Alloc, Layout>::iterator 
+MyContainer<T, Alloc, Layout>::erase(iterator pos) {
+    Node* node = pos.get_node();
+    Node* prev = previous_of(pos);
+    Node* next = node->next;
+    if (prev) {
+        prev->next = next;
+    } else {
+        head = next;
+    }
+    if (tail == node) tail = prev;
     
-    void print_status() const;
+    node_traits::destroy(alloc, node);
+    node_traits::deallocate(alloc, node, 1);
+    count--;
+    return iterator(next, prev);
+}
+
+template <typename T, typename Alloc, typename Layout>
+std::vector<typename MyContainer<T, Alloc, Layout>::iterator>
+MyContainer<T, Alloc, Layout>::split_points(size_t parts) {
+    if (parts > count) parts = count;
+    if (!parts) parts = 1;
+    std::vector<iterator> bounds;
+    bounds.reserve(parts + 1);
+    bounds.push_back(begin());
+    Node* prev = nullptr;
+    Node* current = head;
+    size_t position = 0;
+    for (size_t k = 1; k < parts; ++k) {
+        for (size_t target = count * k / parts; position < target; ++position) {
+            prev = current;
+            current = current->next;
+        }
+        bounds.push_back(iterator(current, prev));
+    }
+    bounds.push_back(end());
+    return bounds;
+}
+
+template <typename T, typename Alloc, typename Layout>
+typename MyContainer<T, Alloc, Layout>::Node* 
+MyContainer<T, Alloc, Layout>::previous_of(iterator pos) {
+    Node* target = pos.get_node();
+    // end(): предыдущий — всегда хвост, даже если итератор получен до добавлений
+    if (!target) return tail;
+    Node* prev = pos.get_previous();
+    if (prev ? prev->next == target : head == target) return prev;
+    return find_previous(target);
+}
+
+// метод find_previous 
+template <typename T, typename Alloc, typename Layout>
+typename MyContainer<T, Alloc, Layout>::Node* 
+MyContainer<T, Alloc, Layout>::find_previous(Node* target) {
+    if (!head || !target || head == target) {
+        return nullptr;
+    }
     
-    // Геттеры
-    T* get_data() const { return data; }
-    size_t get_used() const { return used; }
-    size_t get_capacity() const { return capacity; }
+    Node* current = head;
+    while (current && current->next != target) {
+        current = current->next;
+    }
+    return current;
+}
+
+template <typename T, typename Alloc, typename Layout>
+void MyContainer<T, Alloc, Layout>::clear() {
+    // Память узлов вернется целиком, остается только вызвать деструкторы
+    if constexpr (detail::has_bulk_release<node_allocator>::value) {
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            for (Node* current = head; current; ) {
+                Node* next = current->next;
+                node_traits::destroy(alloc, current);
+                current = next;
+            }
+        }
+        head = tail = nullptr;
+        count = 0;
+        return;
+    }
+    Node* current = head;
+    while (current) {
+        Node* next = current->next;
+        node_traits::destroy(alloc, current);
+        node_traits::deallocate(alloc, current, 1);
+        current = next;
+    }
+    head = tail = nullptr;
+    count = 0;
+}
+
+template <typename T, typename Alloc, typename Layout>
+void MyContainer<T, Alloc, Layout>::print(std::ostream& os) const {
+    Node* current = head;
+    while (current) {
+        os << current->value << " ";
+        current = current->next;
+    }
+    os << std::endl;
+}
+
+template <typename T, typename Alloc, typename Layout>
+size_t MyContainer<T, Alloc, Layout>::size() const {
+    return count;
+}
+
+template <typename T, typename Alloc, typename Layout>
+bool MyContainer<T, Alloc, Layout>::empty() const {
+    return count == 0;
+}
+
+// МОЙ КОНТЕЙНЕР: РАЗВЕРНУТЫЙ СПИСОК
+// Узел хранит до elements_per_node элементов подряд: обход идет по массиву внутри узла,
+// указатель next приходится на узел, а не на каждый элемент.
+// Интерфейс тот же, что у списка с одним элементом в узле.
+template <typename T, typename Alloc, size_t K>
+class MyContainer<T, Alloc, unrolled_layout<K>> {
+private:
+    static constexpr size_t header_size = detail::align_up(sizeof(void*) + sizeof(std::uint32_t), alignof(T));
+    static constexpr size_t fitting = detail::cache_line_size > header_size + sizeof(T)
+                                    ? (detail::cache_line_size - header_size) / sizeof(T) : 1;
+
+public:
+    // Узел по умолчанию занимает одну кэш-линию
+    static constexpr size_t elements_per_node = K ? K : fitting;
+
+private:
+    struct Node {
+        Node* next;
+        std::uint32_t count;
+        alignas(T) unsigned char storage[sizeof(T) * elements_per_node];
+
+        Node() : next(nullptr), count(0) {}
+        T* values() { return std::launder(reinterpret_cast<T*>(storage)); }
+        const T* values() const { return std::launder(reinterpret_cast<const T*>(storage)); }
+    };
+
+    using node_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+    using node_traits = std::allocator_traits<node_allocator>;
+
+    Node* head;
+    Node* tail;
+    size_t count;
+    node_allocator alloc;
+    // Узел перед tail для итератора, который возвращает вставка в конец.
+    // После удаления хвостового узла неизвестен и ищется при первой надобности.
+    Node* before_tail = nullptr;
+    bool before_tail_known = true;
+
+    Node* new_node_after(Node* prev);
+    // Снимает узел node, стоящий за prev, и освобождает его
+    void unlink(Node* prev, Node* node) noexcept;
+    // Предыдущий узел: подсказка итератора, устаревшая подсказка проверяется обходом от head
+    Node* find_previous(Node* node, Node* hint) const;
+    Node* tail_predecessor();
+    // Переносит старшую половину элементов полного узла в новый узел за ним,
+    // перемещение T не должно бросать
+    void split(Node* node);
+    void steal(MyContainer& other) noexcept;
+    void append_copy(const MyContainer& other);
+
+public:
+    // ИТЕРАТОР: узел, номер элемента в нем и предыдущий узел
+    class iterator {
+    private:
+        friend class MyContainer;
+        Node* current;
+        size_t index;
+        Node* previous;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        iterator(Node* node = nullptr, size_t index = 0, Node* previous = nullptr) :
+            current(node), index(index), previous(previous) {}
+
+        T& operator*() { return current->values()[index]; }
+        T* operator->() { return current->values() + index; }
+
+        iterator& operator++() {  // ++it
+            if (++index == current->count) {
+                previous = current;
+                current = current->next;
+                index = 0;
+            }
+            return *this;
+        }
+
+        iterator operator++(int) {  // it++
+            iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const iterator& other) const { return current == other.current && index == other.index; }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+    };
+
+private:
+    // Вставка уже построенного значения перед pos внутри списка: сдвигом в узле,
+    // если перемещение T не бросает, иначе копированием в новый узел
+    iterator emplace_shifting(iterator pos, T&& value);
+    iterator emplace_copying(iterator pos, T& value);
+
+public:
+    MyContainer();
+    explicit MyContainer(const Alloc& alloc);
+    MyContainer(const MyContainer& other);
+    MyContainer(const MyContainer& other, const Alloc& alloc);
+    MyContainer(MyContainer&& other) noexcept;
+    MyContainer(std::initializer_list<T> values, const Alloc& alloc = Alloc());
+    template <typename InputIt, typename = detail::iterator_category_t<InputIt>>
+    MyContainer(InputIt first, InputIt last, const Alloc& alloc = Alloc());
+    ~MyContainer();
+
+    MyContainer& operator=(const MyContainer& other);
+    MyContainer& operator=(MyContainer&& other)
+        noexcept(node_traits::propagate_on_container_move_assignment::value || node_traits::is_always_equal::value);
+
+    void add(const T& value) { emplace_back(value); }
+    void add(T&& value) { emplace_back(std::move(value)); }
+    template <typename... Args>
+    T& emplace_back(Args&&... args);
+    // Добавление диапазона в конец: сначала дозаполняется хвостовой узел,
+    // затем полные узлы выделяются пачками и заполняются по порядку
+    template <typename InputIt>
+    void append(InputIt first, InputIt last);
+    template <typename InputIt>
+    void assign(InputIt first, InputIt last);
+    void assign(std::initializer_list<T> values) { assign(values.begin(), values.end()); }
+    void clear();
+    void print(std::ostream& os) const;
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    Alloc get_allocator() const { return Alloc(alloc); }
+
+    // Методы для итераторов
+    iterator begin() { return iterator(head); }
+    iterator end() { return iterator(nullptr, 0, tail); }
+
+    // Вставка перед pos и удаление pos за O(elements_per_node).
+    // Итераторы на элементы затронутых узлов становятся недействительными.
+    iterator insert(iterator pos, const T& value) { return emplace(pos, value); }
+    iterator insert(iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+    template <typename... Args>
+    iterator emplace(iterator pos, Args&&... args);
+    iterator erase(iterator pos);
+
+    // Разбиение на parts диапазонов по границам узлов: проход идет по узлам, а не по элементам,
+    // длины диапазонов отличаются не больше чем на elements_per_node
+    std::vector<iterator> split_points(size_t parts);
 };
 
-// Инициализация статической переменной
-template <typename T, size_t init_size>
-size_t allocator<T, init_size>::total_blocks = 0;
+// Реализация развернутого списка
+template <typename T, typename Alloc, size_t K>
+MyContainer<T, Alloc, unrolled_layout<K>>::MyContainer() : head(nullptr), tail(nullptr), count(0) {}
+
+template <typename T, typename Alloc, size_t K>
+MyContainer<T, Alloc, unrolled_layout<K>>::MyContainer(const Alloc& alloc) :
+    head(nullptr), tail(nullptr), count(0), alloc(alloc) {}
+
+template <typename T, typename Alloc, size_t K>
+MyContainer<T, Alloc, unrolled_layout<K>>::MyContainer(const MyContainer& other) :
+    head(nullptr), tail(nullptr), count(0),
+    alloc(node_traits::select_on_container_copy_construction(other.alloc))
+{
+    append_copy(other);
+}
+
+template <typename T, typename Alloc, size_t K>
+MyContainer<T, Alloc, unrolled_layout<K>>::MyContainer(const MyContainer& other, const Alloc& alloc) :
+    head(nullptr), tail(nullptr), count(0), alloc(alloc)
+{
+    append_copy(other);
+}
+
+template <typename T, typename Alloc, size_t K>
+MyContainer<T, Alloc, unrolled_layout<K>>::MyContainer(MyContainer&& other) noexcept :
+    head(nullptr), tail(nullptr), count(0), alloc(std::move(other.alloc))
+{
+    steal(other);
+}
 
-// Реализация аллокатора
-template <typename T, size_t init_size>
-allocator<T, init_size>::allocator(): 
-    data(nullptr), next_block(nullptr), block_allocated(false), 
-    used(0), capacity(init_size), block_id(++total_blocks), free_slots(nullptr)
+template <typename T, typename Alloc, size_t K>
+MyContainer<T, Alloc, unrolled_layout<K>>::MyContainer(std::initializer_list<T> values, const Alloc& alloc) :
+    MyContainer(alloc)
 {
-    data = static_cast<T *>(malloc(sizeof(T) * init_size));
-    if (!data) throw std::bad_alloc();
-    else block_allocated = true;
+    append(values.begin(), values.end());
+}
 
-    // Выделяем массив флагов
-    free_slots = static_cast<bool*>(malloc(sizeof(bool) * init_size));
-    if (free_slots) {
-        for (size_t i = 0; i < init_size; ++i) {
-            free_slots[i] = true;  // Все ячейки свободны
-        }
+template <typename T, typename Alloc, size_t K>
+template <typename InputIt, typename>
+MyContainer<T, Alloc, unrolled_layout<K>>::MyContainer(InputIt first, InputIt last, const Alloc& alloc) :
+    MyContainer(alloc)
+{
+    append(first, last);
+}
+
+template <typename T, typename Alloc, size_t K>
+MyContainer<T, Alloc, unrolled_layout<K>>::~MyContainer() {
+    clear();
+}
+
+template <typename T, typename Alloc, size_t K>
+MyContainer<T, Alloc, unrolled_layout<K>>& MyContainer<T, Alloc, unrolled_layout<K>>::operator=(const MyContainer& other) {
+    if (this == &other) return *this;
+    clear();
+    if (node_traits::propagate_on_container_copy_assignment::value) {
+        alloc = other.alloc;
     }
+    append_copy(other);
+    return *this;
 }
 
-template <typename T, size_t init_size>
-template <typename U>
-allocator<T, init_size>::allocator(const allocator<U, init_size>&) : 
-    data(nullptr), next_block(nullptr), block_allocated(false), 
-    used(0), capacity(init_size), block_id(++total_blocks), free_slots(nullptr) 
+template <typename T, typename Alloc, size_t K>
+MyContainer<T, Alloc, unrolled_layout<K>>& MyContainer<T, Alloc, unrolled_layout<K>>::operator=(MyContainer&& other)
+    noexcept(node_traits::propagate_on_container_move_assignment::value || node_traits::is_always_equal::value)
 {
-    data = static_cast<T *>(malloc(sizeof(T) * init_size));
-    if (!data) throw std::bad_alloc();
-    else block_allocated = true;
+    if (this == &other) return *this;
+    clear();
+    if constexpr (node_traits::propagate_on_container_move_assignment::value) {
+        alloc = std::move(other.alloc);
+        steal(other);
+    } else {
+        if (alloc == other.alloc) {
+            steal(other);
+        } else {
+            for (Node* current = other.head; current; current = current->next) {
+                for (size_t i = 0; i < current->count; ++i) {
+                    emplace_back(std::move(current->values()[i]));
+                }
+            }
+            other.clear();
+        }
+    }
+    return *this;
+}
+
+template <typename T, typename Alloc, size_t K>
+void MyContainer<T, Alloc, unrolled_layout<K>>::steal(MyContainer& other) noexcept {
+    head = other.head;
+    tail = other.tail;
+    count = other.count;
+    before_tail = other.before_tail;
+    before_tail_known = other.before_tail_known;
+    other.head = other.tail = other.before_tail = nullptr;
+    other.before_tail_known = true;
+    other.count = 0;
+}
 
-    // Выделяем массив флагов
-    free_slots = static_cast<bool*>(malloc(sizeof(bool) * init_size));
-    if (free_slots) {
-        for (size_t i = 0; i < init_size; ++i) {
-            free_slots[i] = true;  // Все ячейки свободны
+template <typename T, typename Alloc, size_t K>
+void MyContainer<T, Alloc, unrolled_layout<K>>::append_copy(const MyContainer& other) {
+    try {
+        for (const Node* current = other.head; current; current = current->next) {
+            for (size_t i = 0; i < current->count; ++i) {
+                emplace_back(current->values()[i]);
+            }
         }
+    } catch (...) {
+        clear();
+        throw;
     }
 }
 
-template <typename T, size_t init_size>
-allocator<T, init_size>::~allocator()
-{
-    if (data && block_allocated) {
-        free(data); 
-        data = nullptr;
+// Пустой узел после prev, при prev == nullptr — в начале списка
+template <typename T, typename Alloc, size_t K>
+typename MyContainer<T, Alloc, unrolled_layout<K>>::Node*
+MyContainer<T, Alloc, unrolled_layout<K>>::new_node_after(Node* prev) {
+    Node* node = node_traits::allocate(alloc, 1);
+    node_traits::construct(alloc, node);
+    if (prev) {
+        node->next = prev->next;
+        prev->next = node;
+    } else {
+        node->next = head;
+        head = node;
     }
-    if (free_slots) {
-        free(free_slots);
-        free_slots = nullptr;
+    if (tail == prev) {
+        before_tail = prev;
+        before_tail_known = true;
+        tail = node;
+    } else if (node->next == tail) {
+        before_tail = node;
+        before_tail_known = true;
     }
+    return node;
 }
 
-template <typename T, size_t init_size>
-T* allocator<T, init_size>::allocate(size_t n) {
-    if (n == 0) { return nullptr; }
-    if (n > init_size)
-    {
-        std::cerr << "ОШИБКА: Запрос " << n << " превышает размер блока " << init_size << "\n";
-        throw std::bad_alloc();
+template <typename T, typename Alloc, size_t K>
+void MyContainer<T, Alloc, unrolled_layout<K>>::unlink(Node* prev, Node* node) noexcept {
+    (prev ? prev->next : head) = node->next;
+    if (tail == node) {
+        tail = prev;
+        before_tail = nullptr;
+        before_tail_known = !prev || prev == head;
+    } else if (before_tail_known && before_tail == node) {
+        before_tail = prev;
     }
-    // Поиск n последовательных свободных ячеек
-    size_t free_count = 0;
-    for (size_t i = 0; i < capacity; ++i) {
-        if (free_slots[i]) {
-            free_count++;
-            if (free_count == n) {
-                size_t start_index = i - n + 1;
-                for (size_t j = 0; j < n; ++j) {
-                    free_slots[start_index + j] = false;
-                }
-                used += n;
-                return data + start_index;
-            }
-        } else {
-            free_count = 0;
-        }
+    node_traits::destroy(alloc, node);
+    node_traits::deallocate(alloc, node, 1);
+}
+
+template <typename T, typename Alloc, size_t K>
+typename MyContainer<T, Alloc, unrolled_layout<K>>::Node*
+MyContainer<T, Alloc, unrolled_layout<K>>::find_previous(Node* node, Node* hint) const {
+    if (hint ? hint->next == node : head == node) return hint;
+    Node* prev = head == node ? nullptr : head;
+    while (prev && prev->next != node) prev = prev->next;
+    return prev;
+}
+
+template <typename T, typename Alloc, size_t K>
+typename MyContainer<T, Alloc, unrolled_layout<K>>::Node*
+MyContainer<T, Alloc, unrolled_layout<K>>::tail_predecessor() {
+    if (!before_tail_known) {
+        before_tail = find_previous(tail, nullptr);
+        before_tail_known = true;
     }
-    
-    // Не нашли места в текущем блоке
-    if (!next_block) {
-        next_block = new allocator<T, init_size>();
+    return before_tail;
+}
+
+template <typename T, typename Alloc, size_t K>
+void MyContainer<T, Alloc, unrolled_layout<K>>::split(Node* node) {
+    Node* upper = new_node_after(node);
+    size_t half = node->count / 2;
+    for (size_t i = half; i < node->count; ++i) {
+        node_traits::construct(alloc, upper->values() + (i - half), std::move(node->values()[i]));
+        node_traits::destroy(alloc, node->values() + i);
     }
-    return next_block->allocate(n);
+    upper->count = static_cast<std::uint32_t>(node->count - half);
+    node->count = static_cast<std::uint32_t>(half);
 }
 
-template <typename T, size_t init_size>
-void allocator<T, init_size>::deallocate(T* p, size_t n) noexcept 
-{
-    if (!p || n == 0) return;
-    if (p >= data && p < data + capacity && free_slots) 
-    {   
-        size_t index = p - data;
-        for (size_t i = 0; i < n; ++i)
-        {
-            if (index + i < capacity)
-            {
-                if (!free_slots[index + i])
-                {
-                    // Ячейка была занята, теперь свободна
-                    free_slots[index + i] = true;
-                }
-                else
-                {
-                    std::cerr << "ОШИБКА: Повторное освобождение по адресу " << p << ", слот " << (index + i) << ", в блоке " << block_id << "\n";
-                    /*throw std::bad_alloc();*/
+template <typename T, typename Alloc, size_t K>
+template <typename... Args>
+T& MyContainer<T, Alloc, unrolled_layout<K>>::emplace_back(Args&&... args) {
+    Node* old_tail = tail;
+    Node* old_before_tail = before_tail;
+    bool old_before_tail_known = before_tail_known;
+    Node* node = tail && tail->count < elements_per_node ? tail : new_node_after(tail);
+    try {
+        node_traits::construct(alloc, node->values() + node->count, std::forward<Args>(args)...);
+    } catch (...) {
+        if (node != old_tail) {
+            // Узел только что добавлен в хвост и пуст: снимаем его обратно
+            (old_tail ? old_tail->next : head) = nullptr;
+            tail = old_tail;
+            before_tail = old_before_tail;
+            before_tail_known = old_before_tail_known;
+            node_traits::destroy(alloc, node);
+            node_traits::deallocate(alloc, node, 1);
+        }
+        throw;
+    }
+    ++node->count;
+    ++count;
+    return node->values()[node->count - 1];
+}
+
+template <typename T, typename Alloc, size_t K>
+template <typename InputIt>
+void MyContainer<T, Alloc, unrolled_layout<K>>::append(InputIt first, InputIt last) {
+    if constexpr (!detail::is_forward_iterator<InputIt>) {
+        for (; first != last; ++first) emplace_back(*first);
+    } else {
+        size_t remaining = static_cast<size_t>(std::distance(first, last));
+        for (; remaining && tail && tail->count < elements_per_node; --remaining, ++first) {
+            emplace_back(*first);
+        }
+
+        Node* batch[detail::node_batch_size];
+        while (remaining) {
+            size_t nodes = (remaining + elements_per_node - 1) / elements_per_node;
+            if (nodes > detail::node_batch_size) nodes = detail::node_batch_size;
+            detail::allocate_each(alloc, batch, nodes);
+            size_t filled = 0;
+            try {
+                for (; filled < nodes; ++filled) {
+                    Node* node = batch[filled];
+                    node_traits::construct(alloc, node);
+                    size_t take = remaining < elements_per_node ? remaining : elements_per_node;
+                    for (; node->count < take; ++node->count, ++first) {
+                        node_traits::construct(alloc, node->values() + node->count, *first);
+                    }
+                    (tail ? tail->next : head) = node;
+                    before_tail = tail;
+                    before_tail_known = true;
+                    tail = node;
+                    count += take;
+                    remaining -= take;
                 }
+            } catch (...) {
+                // Недозаполненный узел разбирается, память остальных возвращается
+                Node* node = batch[filled];
+                for (size_t i = 0; i < node->count; ++i) node_traits::destroy(alloc, node->values() + i);
+                node_traits::destroy(alloc, node);
+                for (size_t i = filled; i < nodes; ++i) node_traits::deallocate(alloc, batch[i], 1);
+                throw;
             }
         }
-        used -= n;
-    }
-    else if (next_block)
-    {
-        next_block->deallocate(p, n);
     }
 }
 
-template <typename T, size_t init_size>
-template <typename U, typename... Args>
-void allocator<T, init_size>::construct(U* p, Args&&... args) {
-    ::new((void*)p) U(std::forward<Args>(args)...);
+template <typename T, typename Alloc, size_t K>
+template <typename InputIt>
+void MyContainer<T, Alloc, unrolled_layout<K>>::assign(InputIt first, InputIt last) {
+    clear();
+    append(first, last);
 }
 
-template <typename T, size_t init_size>    
-template<typename U>
-void allocator<T, init_size>::destroy(U* p) noexcept {
-    p->~U();
+template <typename T, typename Alloc, size_t K>
+template <typename... Args>
+typename MyContainer<T, Alloc, unrolled_layout<K>>::iterator
+MyContainer<T, Alloc, unrolled_layout<K>>::emplace(iterator pos, Args&&... args) {
+    if (!pos.current) {
+        Node* old_tail = tail;
+        emplace_back(std::forward<Args>(args)...);
+        return iterator(tail, tail->count - 1, tail == old_tail ? tail_predecessor() : old_tail);
+    }
+
+    // Элемент строится до сдвига и разбиения: args может ссылаться на элемент
+    // этого же узла, а исключение из конструктора оставляет контейнер нетронутым
+    T value(std::forward<Args>(args)...);
+    if constexpr (std::is_nothrow_move_constructible<T>::value) {
+        return emplace_shifting(pos, std::move(value));
+    } else {
+        return emplace_copying(pos, value);
+    }
+}
+
+// После выделения узла для разбиения исключений нет: перемещение T не бросает
+template <typename T, typename Alloc, size_t K>
+typename MyContainer<T, Alloc, unrolled_layout<K>>::iterator
+MyContainer<T, Alloc, unrolled_layout<K>>::emplace_shifting(iterator pos, T&& value) {
+    Node* node = pos.current;
+    size_t index = pos.index;
+    if (node->count == elements_per_node) {
+        split(node);
+        if (index > node->count) {
+            index -= node->count;
+            node = node->next;
+        }
+    }
+
+    // Сдвиг хвоста узла на одну позицию вправо
+    T* values = node->values();
+    for (size_t i = node->count; i > index; --i) {
+        node_traits::construct(alloc, values + i, std::move(values[i - 1]));
+        node_traits::destroy(alloc, values + i - 1);
+    }
+    node_traits::construct(alloc, values + index, std::move(value));
+    ++node->count;
+    ++count;
+    return iterator(node, index, node == pos.current ? pos.previous : pos.current);
 }
 
-template <typename T, size_t init_size> 
-size_t allocator<T, init_size>::max_size() const noexcept {
-    return init_size;
+// Перемещение T может бросить: значение и хвост узла от pos копируются в новый узел,
+// старые элементы удаляются только после успеха. При исключении контейнер не меняется.
+template <typename T, typename Alloc, size_t K>
+typename MyContainer<T, Alloc, unrolled_layout<K>>::iterator
+MyContainer<T, Alloc, unrolled_layout<K>>::emplace_copying(iterator pos, T& value) {
+    Node* node = pos.current;
+    size_t index = pos.index;
+    if (index == 0) {
+        // Перед первым элементом узла: отдельный узел перед ним
+        Node* prev = find_previous(node, pos.previous);
+        Node* fresh = new_node_after(prev);
+        try {
+            node_traits::construct(alloc, fresh->values(), std::move_if_noexcept(value));
+        } catch (...) {
+            unlink(prev, fresh);
+            throw;
+        }
+        fresh->count = 1;
+        ++count;
+        return iterator(fresh, 0, prev);
+    }
+
+    Node* upper = new_node_after(node);
+    try {
+        node_traits::construct(alloc, upper->values(), std::move_if_noexcept(value));
+        for (upper->count = 1; index + upper->count - 1 < node->count; ++upper->count) {
+            node_traits::construct(alloc, upper->values() + upper->count,
+                                   std::move_if_noexcept(node->values()[index + upper->count - 1]));
+        }
+    } catch (...) {
+        for (size_t i = 0; i < upper->count; ++i) node_traits::destroy(alloc, upper->values() + i);
+        unlink(node, upper);
+        throw;
+    }
+    for (size_t i = index; i < node->count; ++i) node_traits::destroy(alloc, node->values() + i);
+    node->count = static_cast<std::uint32_t>(index);
+    ++count;
+    return iterator(upper, 0, node);
 }
 
-template <typename T, size_t init_size>     
-template<typename U>
-bool allocator<T, init_size>::operator==(const allocator<U, init_size>&) const noexcept {
-    return true;  
+template <typename T, typename Alloc, size_t K>
+typename MyContainer<T, Alloc, unrolled_layout<K>>::iterator
+MyContainer<T, Alloc, unrolled_layout<K>>::erase(iterator pos) {
+    Node* node = pos.current;
+    size_t index = pos.index;
+
+    // Сдвиг хвоста узла на одну позицию влево
+    T* values = node->values();
+    node_traits::destroy(alloc, values + index);
+    for (size_t i = index + 1; i < node->count; ++i) {
+        node_traits::construct(alloc, values + i - 1, std::move(values[i]));
+        node_traits::destroy(alloc, values + i);
+    }
+    --node->count;
+    --count;
+    if (index < node->count) return iterator(node, index, pos.previous);
+
+    Node* next = node->next;
+    if (node->count) return iterator(next, 0, node);
+
+    // Узел опустел: предыдущий узел знает итератор
+    Node* prev = find_previous(node, pos.previous);
+    unlink(prev, node);
+    return iterator(next, 0, prev);
 }
 
-template <typename T, size_t init_size>    
-template<typename U>
-bool allocator<T, init_size>::operator!=(const allocator<U, init_size>& other) const noexcept {
-    return !(*this == other);
+template <typename T, typename Alloc, size_t K>
+std::vector<typename MyContainer<T, Alloc, unrolled_layout<K>>::iterator>
+MyContainer<T, Alloc, unrolled_layout<K>>::split_points(size_t parts) {
+    if (!parts) parts = 1;
+    std::vector<iterator> bounds;
+    bounds.reserve(parts + 1);
+    bounds.push_back(begin());
+    Node* prev = nullptr;
+    Node* current = head;
+    size_t position = 0;
+    for (size_t k = 1; k < parts; ++k) {
+        // Первое начало узла не раньше целевой позиции; пустые диапазоны допустимы
+        for (size_t target = count * k / parts; current && position < target; current = current->next) {
+            position += current->count;
+            prev = current;
+        }
+        bounds.push_back(iterator(current, 0, prev));
+    }
+    bounds.push_back(end());
+    return bounds;
 }
 
-template <typename T, size_t init_size> 
-void allocator<T, init_size>::print_status() const {
-    std::cout << "Блок #" << block_id << ": "
-              << "использовано " << used << "/" << capacity 
-              << " (" << (used * 100 / capacity) << "%), "
-              << "адрес начала: " << data 
-              << ", следующий блок: " << (next_block ? "есть" : "нет") << "\n";
+template <typename T, typename Alloc, size_t K>
+void MyContainer<T, Alloc, unrolled_layout<K>>::clear() {
+    Node* current = head;
+    while (current) {
+        Node* next = current->next;
+        if (!std::is_trivially_destructible<T>::value) {
+            for (size_t i = 0; i < current->count; ++i) {
+                node_traits::destroy(alloc, current->values() + i);
+            }
+        }
+        // Память узлов вернется целиком
+        if (!detail::has_bulk_release<node_allocator>::value) {
+            node_traits::destroy(alloc, current);
+            node_traits::deallocate(alloc, current, 1);
+        }
+        current = next;
+    }
+    head = tail = before_tail = nullptr;
+    before_tail_known = true;
+    count = 0;
 }
 
-// Оператор вывода
-template <typename T, size_t N>
-std::ostream& operator<<(std::ostream& os, const allocator<T, N>& alloc) {
-    os << "allocator[блок #" << reinterpret_cast<const void*>(&alloc) 
-       << ", data=" << alloc.get_data() 
-       << ", used=" << alloc.get_used() 
-       << "/" << alloc.get_capacity() << "]";
-    return os;
+template <typename T, typename Alloc, size_t K>
+void MyContainer<T, Alloc, unrolled_layout<K>>::print(std::ostream& os) const {
+    for (const Node* current = head; current; current = current->next) {
+        for (size_t i = 0; i < current->count; ++i) {
+            os << current->values()[i] << " ";
+        }
+    }
+    os << std::endl;
 }
 
-// МОЙ КОНТЕЙНЕР 
-template <typename T, typename Alloc = std::allocator<T>>
-class MyContainer {
+// МОЙ КОНТЕЙНЕР: УПОРЯДОЧЕННЫЙ СПИСОК
+// Элементы лежат в том же односвязном списке узлов, по возрастанию Compare, равные —
+// в порядке вставки. Над списком строится индекс skip-list: узел индекса уровня L
+// ссылается на элемент, на следующий узел своего уровня и на узел уровня L - 1.
+// Элемент попадает на уровень L с вероятностью 4^-(L + 1), поэтому find, lower_bound,
+// insert и erase проходят O(log n) узлов в среднем. Узлы индекса выделяются тем же
+// аллокатором через rebind: на арене пула это соседний подпул той же арены.
+template <typename T, typename Alloc, typename Compare>
+class MyContainer<T, Alloc, ordered_layout<Compare>> {
 private:
     struct Node {
         T value;
         Node* next;
-        Node(const T& val);
+        template <typename... Args>
+        explicit Node(std::in_place_t, Args&&... args) : value(std::forward<Args>(args)...), next(nullptr) {}
     };
-    
+
+    // Заголовки уровней (столбец от top вниз) имеют node == nullptr
+    struct Index {
+        Node* node;
+        Index* right;
+        Index* down;
+    };
+
+    static constexpr size_t max_levels = 32;
+
+    using node_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+    using node_traits = std::allocator_traits<node_allocator>;
+    using index_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<Index>;
+    using index_traits = std::allocator_traits<index_allocator>;
+
     Node* head;
     Node* tail;
     size_t count;
-    typename Alloc::template rebind<Node>::other alloc;
+    // Заголовок верхнего уровня индекса и число уровней, без индекса — nullptr и 0
+    Index* top;
+    size_t levels;
+    std::uint64_t seed;
+    Compare compare;
+    node_allocator alloc;
+    // Привязывается к арене alloc, пока индекс пуст; optional — потому что
+    // не у всех аллокаторов есть присваивание (polymorphic_allocator)
+    std::optional<index_allocator> index_alloc;
+
+    index_allocator& get_index_alloc();
+    std::size_t random_height();
+    // Последний элемент, для которого before(value) истинно, или nullptr.
+    // path[L] — последний узел уровня L с тем же свойством или заголовок уровня.
+    template <typename Before>
+    Node* find_last(Before before, Index** path) const;
+    void free_index() noexcept;
+    void steal(MyContainer& other) noexcept;
+    void append_copy(const MyContainer& other);
 
 public:
-    // ИТЕРАТОР
+    // ИТЕРАТОР: только чтение, изменение элемента нарушило бы порядок
     class iterator {
-        
     private:
+        friend class MyContainer;
         Node* current;
-        
+        Node* previous;
+
     public:
-        iterator(Node* node = nullptr) : current(node) {}
-        
-        T& operator*() { return current->value; }
-        T* operator->() { return &current->value; }
-        
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        iterator(Node* node = nullptr, Node* previous = nullptr) : current(node), previous(previous) {}
+
+        const T& operator*() const { return current->value; }
+        const T* operator->() const { return &current->value; }
+
         iterator& operator++() {  // ++it
+            previous = current;
             current = current->next;
             return *this;
         }
-        
+
         iterator operator++(int) {  // it++
             iterator old = *this;
-            current = current->next;
+            ++*this;
             return old;
         }
-        
+
         bool operator==(const iterator& other) const { return current == other.current; }
         bool operator!=(const iterator& other) const { return current != other.current; }
-        
-        // Для доступа к узлу внутри insert
-        Node* get_node() { return current; }
     };
-    
+    using const_iterator = iterator;
+
 public:
     MyContainer();
+    explicit MyContainer(const Alloc& alloc);
+    explicit MyContainer(const Compare& compare, const Alloc& alloc = Alloc());
+    MyContainer(const MyContainer& other);
+    MyContainer(const MyContainer& other, const Alloc& alloc);
+    MyContainer(MyContainer&& other) noexcept;
+    MyContainer(std::initializer_list<T> values, const Alloc& alloc = Alloc());
+    template <typename InputIt, typename = detail::iterator_category_t<InputIt>>
+    MyContainer(InputIt first, InputIt last, const Alloc& alloc = Alloc());
     ~MyContainer();
-    
-    void add(const T& value);
-    void clear();
-    void print() const;
-    size_t size() const;
-    bool empty() const;
 
-    // Методы для итераторов
-    iterator begin() { return iterator(head); }
-    iterator end() { return iterator(nullptr); }
-    
-    // insert
-    iterator insert(iterator pos, const T& value);
+    MyContainer& operator=(const MyContainer& other);
+    MyContainer& operator=(MyContainer&& other)
+        noexcept(node_traits::propagate_on_container_move_assignment::value || node_traits::is_always_equal::value);
 
-private:
-    // метод для поиска предыдущего узла
-    Node* find_previous(Node* target);
+    // Вставка на свое место за O(log n), после равных элементов
+    iterator insert(const T& value) { return emplace(value); }
+    iterator insert(T&& value) { return emplace(std::move(value)); }
+    template <typename... Args>
+    iterator emplace(Args&&... args);
+    // add и append вставляют по порядку: контейнер подходит для тех же функций заполнения
+    void add(const T& value) { emplace(value); }
+    void add(T&& value) { emplace(std::move(value)); }
+    template <typename InputIt>
+    void append(InputIt first, InputIt last);
+    template <typename InputIt>
+    void assign(InputIt first, InputIt last);
+    void assign(std::initializer_list<T> values) { assign(values.begin(), values.end()); }
+
+    // Поиск за O(log n)
+    template <typename K>
+    iterator lower_bound(const K& key) const;
+    template <typename K>
+    iterator upper_bound(const K& key) const;
+    // Первый из равных key или end()
+    template <typename K>
+    iterator find(const K& key) const;
+    template <typename K>
+    bool contains(const K& key) const { return find(key) != end(); }
+
+    // Удаление pos за O(log n), возвращает итератор на следующий.
+    // Итераторы на pos и на следующий элемент недействительны.
+    iterator erase(iterator pos);
+
+    void clear();
+    void print(std::ostream& os) const;
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    Alloc get_allocator() const { return Alloc(alloc); }
+    Compare key_comp() const { return compare; }
+    // Число уровней индекса над списком
+    size_t index_levels() const { return levels; }
+
+    iterator begin() const { return iterator(head); }
+    iterator end() const { return iterator(nullptr, tail); }
 };
 
-// Реализация MyContainer
-template <typename T, typename Alloc>
-MyContainer<T, Alloc>::Node::Node(const T& val) : value(val), next(nullptr) {}
+// Реализация упорядоченного списка
+template <typename T, typename Alloc, typename Compare>
+MyContainer<T, Alloc, ordered_layout<Compare>>::MyContainer() :
+    head(nullptr), tail(nullptr), count(0), top(nullptr), levels(0), seed(detail::skip_list_seed) {}
+
+template <typename T, typename Alloc, typename Compare>
+MyContainer<T, Alloc, ordered_layout<Compare>>::MyContainer(const Alloc& alloc) :
+    head(nullptr), tail(nullptr), count(0), top(nullptr), levels(0), seed(detail::skip_list_seed), alloc(alloc) {}
+
+template <typename T, typename Alloc, typename Compare>
+MyContainer<T, Alloc, ordered_layout<Compare>>::MyContainer(const Compare& compare, const Alloc& alloc) :
+    head(nullptr), tail(nullptr), count(0), top(nullptr), levels(0), seed(detail::skip_list_seed),
+    compare(compare), alloc(alloc) {}
+
+template <typename T, typename Alloc, typename Compare>
+MyContainer<T, Alloc, ordered_layout<Compare>>::MyContainer(const MyContainer& other) :
+    head(nullptr), tail(nullptr), count(0), top(nullptr), levels(0), seed(detail::skip_list_seed),
+    compare(other.compare), alloc(node_traits::select_on_container_copy_construction(other.alloc))
+{
+    append_copy(other);
+}
+
+template <typename T, typename Alloc, typename Compare>
+MyContainer<T, Alloc, ordered_layout<Compare>>::MyContainer(const MyContainer& other, const Alloc& alloc) :
+    head(nullptr), tail(nullptr), count(0), top(nullptr), levels(0), seed(detail::skip_list_seed),
+    compare(other.compare), alloc(alloc)
+{
+    append_copy(other);
+}
+
+template <typename T, typename Alloc, typename Compare>
+MyContainer<T, Alloc, ordered_layout<Compare>>::MyContainer(MyContainer&& other) noexcept :
+    head(nullptr), tail(nullptr), count(0), top(nullptr), levels(0), seed(other.seed),
+    compare(other.compare), alloc(std::move(other.alloc))
+{
+    steal(other);
+}
+
+template <typename T, typename Alloc, typename Compare>
+MyContainer<T, Alloc, ordered_layout<Compare>>::MyContainer(std::initializer_list<T> values, const Alloc& alloc) :
+    MyContainer(alloc)
+{
+    append(values.begin(), values.end());
+}
 
-template <typename T, typename Alloc>
-MyContainer<T, Alloc>::MyContainer() : head(nullptr), tail(nullptr), count(0) {}
+template <typename T, typename Alloc, typename Compare>
+template <typename InputIt, typename>
+MyContainer<T, Alloc, ordered_layout<Compare>>::MyContainer(InputIt first, InputIt last, const Alloc& alloc) :
+    MyContainer(alloc)
+{
+    append(first, last);
+}
 
-template <typename T, typename Alloc>
-MyContainer<T, Alloc>::~MyContainer() {
+template <typename T, typename Alloc, typename Compare>
+MyContainer<T, Alloc, ordered_layout<Compare>>::~MyContainer() {
     clear();
 }
 
-template <typename T, typename Alloc>
-void MyContainer<T, Alloc>::add(const T& value) {
-    insert(end(), value);  // Просто вставка в конец
+template <typename T, typename Alloc, typename Compare>
+MyContainer<T, Alloc, ordered_layout<Compare>>& MyContainer<T, Alloc, ordered_layout<Compare>>::operator=(const MyContainer& other) {
+    if (this == &other) return *this;
+    clear();
+    if (node_traits::propagate_on_container_copy_assignment::value) {
+        alloc = other.alloc;
+    }
+    compare = other.compare;
+    append_copy(other);
+    return *this;
 }
 
-// Метод insert
-template <typename T, typename Alloc>
-typename MyContainer<T, Alloc>::iterator 
-MyContainer<T, Alloc>::insert(iterator pos, const T& value) {
-    // Создаем новый узел
-    Node* new_node = alloc.allocate(1);
-    alloc.construct(new_node, value);
-    
-    Node* pos_node = pos.get_node();
-    
-    // Если вставляем в начало или список пустой
-    if (pos_node == head || !head) {
-        new_node->next = head;
-        head = new_node;
-        if (!tail) tail = new_node;
-    }
-    // Если вставляем в конец (pos == end())
-    else if (!pos_node) {
-        tail->next = new_node;
-        tail = new_node;
-    }
-    // Вставляем в середину
-    else {
-        Node* prev = find_previous(pos_node);
-        if (prev) {
-            new_node->next = prev->next;
-            prev->next = new_node;
+// Узлы и индекс можно забрать, если память other освобождается нашим аллокатором,
+// иначе элементы перемещаются по одному
+template <typename T, typename Alloc, typename Compare>
+MyContainer<T, Alloc, ordered_layout<Compare>>& MyContainer<T, Alloc, ordered_layout<Compare>>::operator=(MyContainer&& other)
+    noexcept(node_traits::propagate_on_container_move_assignment::value || node_traits::is_always_equal::value)
+{
+    if (this == &other) return *this;
+    clear();
+    compare = other.compare;
+    if constexpr (node_traits::propagate_on_container_move_assignment::value) {
+        alloc = std::move(other.alloc);
+        steal(other);
+    } else {
+        if (alloc == other.alloc) {
+            steal(other);
         } else {
-            // На всякий случай
-            new_node->next = head;
-            head = new_node;
+            for (Node* current = other.head; current; current = current->next) {
+                emplace(std::move(current->value));
+            }
+            other.clear();
         }
     }
-    
-    count++;
-    return iterator(new_node);
+    return *this;
 }
 
-// метод find_previous 
-template <typename T, typename Alloc>
-typename MyContainer<T, Alloc>::Node* 
-MyContainer<T, Alloc>::find_previous(Node* target) {
-    if (!head || !target || head == target) {
-        return nullptr;
+// Индекс переезжает вместе с аллокатором, которым выделены его узлы
+template <typename T, typename Alloc, typename Compare>
+void MyContainer<T, Alloc, ordered_layout<Compare>>::steal(MyContainer& other) noexcept {
+    head = other.head;
+    tail = other.tail;
+    count = other.count;
+    top = other.top;
+    levels = other.levels;
+    if (other.top) index_alloc.emplace(*other.index_alloc);
+    other.head = other.tail = nullptr;
+    other.count = 0;
+    other.top = nullptr;
+    other.levels = 0;
+}
+
+template <typename T, typename Alloc, typename Compare>
+void MyContainer<T, Alloc, ordered_layout<Compare>>::append_copy(const MyContainer& other) {
+    try {
+        for (const Node* current = other.head; current; current = current->next) {
+            emplace(current->value);
+        }
+    } catch (...) {
+        clear();
+        throw;
     }
-    
-    Node* current = head;
-    while (current && current->next != target) {
+}
+
+template <typename T, typename Alloc, typename Compare>
+template <typename InputIt>
+void MyContainer<T, Alloc, ordered_layout<Compare>>::append(InputIt first, InputIt last) {
+    for (; first != last; ++first) emplace(*first);
+}
+
+template <typename T, typename Alloc, typename Compare>
+template <typename InputIt>
+void MyContainer<T, Alloc, ordered_layout<Compare>>::assign(InputIt first, InputIt last) {
+    clear();
+    append(first, last);
+}
+
+template <typename T, typename Alloc, typename Compare>
+typename MyContainer<T, Alloc, ordered_layout<Compare>>::index_allocator&
+MyContainer<T, Alloc, ordered_layout<Compare>>::get_index_alloc() {
+    if (!top) index_alloc.emplace(alloc);
+    return *index_alloc;
+}
+
+// xorshift64: каждые два нулевых младших бита поднимают элемент на уровень выше.
+// Новый уровень добавляется не больше чем по одному за вставку.
+template <typename T, typename Alloc, typename Compare>
+std::size_t MyContainer<T, Alloc, ordered_layout<Compare>>::random_height() {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    std::uint64_t bits = seed;
+    size_t height = 0;
+    while ((bits & 3) == 0 && height < max_levels) {
+        ++height;
+        bits >>= 2;
+    }
+    return height > levels ? levels + 1 : height;
+}
+
+template <typename T, typename Alloc, typename Compare>
+template <typename Before>
+typename MyContainer<T, Alloc, ordered_layout<Compare>>::Node*
+MyContainer<T, Alloc, ordered_layout<Compare>>::find_last(Before before, Index** path) const {
+    Index* x = top;
+    for (size_t level = levels; level-- > 0;) {
+        while (x->right && before(x->right->node->value)) x = x->right;
+        if (path) path[level] = x;
+        if (level) x = x->down;
+    }
+    // Спуск с нижнего уровня индекса на список
+    Node* prev = x ? x->node : nullptr;
+    Node* current = prev ? prev->next : head;
+    while (current && before(current->value)) {
+        prev = current;
         current = current->next;
     }
-    return current;
+    return prev;
 }
 
-template <typename T, typename Alloc>
-void MyContainer<T, Alloc>::clear() {
-    Node* current = head;
-    while (current) {
-        Node* next = current->next;
-        alloc.destroy(current);
-        alloc.deallocate(current, 1);
-        current = next;
+template <typename T, typename Alloc, typename Compare>
+template <typename K>
+typename MyContainer<T, Alloc, ordered_layout<Compare>>::iterator
+MyContainer<T, Alloc, ordered_layout<Compare>>::lower_bound(const K& key) const {
+    Node* prev = find_last([&](const T& value) { return compare(value, key); }, nullptr);
+    return iterator(prev ? prev->next : head, prev);
+}
+
+template <typename T, typename Alloc, typename Compare>
+template <typename K>
+typename MyContainer<T, Alloc, ordered_layout<Compare>>::iterator
+MyContainer<T, Alloc, ordered_layout<Compare>>::upper_bound(const K& key) const {
+    Node* prev = find_last([&](const T& value) { return !compare(key, value); }, nullptr);
+    return iterator(prev ? prev->next : head, prev);
+}
+
+template <typename T, typename Alloc, typename Compare>
+template <typename K>
+typename MyContainer<T, Alloc, ordered_layout<Compare>>::iterator
+MyContainer<T, Alloc, ordered_layout<Compare>>::find(const K& key) const {
+    iterator it = lower_bound(key);
+    if (it != end() && !compare(key, *it)) return it;
+    return end();
+}
+
+// Все узлы (элемент, узлы индекса, новые заголовки) выделяются до того, как что-либо
+// связывается: исключение оставляет контейнер без изменений
+template <typename T, typename Alloc, typename Compare>
+template <typename... Args>
+typename MyContainer<T, Alloc, ordered_layout<Compare>>::iterator
+MyContainer<T, Alloc, ordered_layout<Compare>>::emplace(Args&&... args) {
+    Node* node = node_traits::allocate(alloc, 1);
+    try {
+        node_traits::construct(alloc, node, std::in_place, std::forward<Args>(args)...);
+    } catch (...) {
+        node_traits::deallocate(alloc, node, 1);
+        throw;
     }
-    head = tail = nullptr;
-    count = 0;
+
+    size_t height = random_height();
+    size_t new_levels = height > levels ? height - levels : 0;
+    Index* made[max_levels + 1];
+    size_t allocated = 0;
+    try {
+        index_allocator& ia = get_index_alloc();
+        for (; allocated < height + new_levels; ++allocated) made[allocated] = index_traits::allocate(ia, 1);
+    } catch (...) {
+        while (allocated) index_traits::deallocate(*index_alloc, made[--allocated], 1);
+        node_traits::destroy(alloc, node);
+        node_traits::deallocate(alloc, node, 1);
+        throw;
+    }
+
+    // Новый уровень: заголовок над прежним верхним
+    Index* path[max_levels];
+    for (size_t i = 0; i < new_levels; ++i) {
+        Index* header = made[height + i];
+        *header = Index{nullptr, nullptr, top};
+        top = header;
+        ++levels;
+    }
+    const T& value = node->value;
+    Node* prev = find_last([&](const T& other) { return !compare(value, other); }, path);
+
+    node->next = prev ? prev->next : head;
+    (prev ? prev->next : head) = node;
+    if (!node->next) tail = node;
+    for (size_t level = 0; level < height; ++level) {
+        made[level]->node = node;
+        made[level]->right = path[level]->right;
+        made[level]->down = level ? made[level - 1] : nullptr;
+        path[level]->right = made[level];
+    }
+    ++count;
+    return iterator(node, prev);
 }
 
-template <typename T, typename Alloc>
-void MyContainer<T, Alloc>::print() const {
-    Node* current = head;
-    while (current) {
-        std::cout << current->value << " ";
-        current = current->next;
+template <typename T, typename Alloc, typename Compare>
+typename MyContainer<T, Alloc, ordered_layout<Compare>>::iterator
+MyContainer<T, Alloc, ordered_layout<Compare>>::erase(iterator pos) {
+    Node* node = pos.current;
+    const T& key = node->value;
+    Index* path[max_levels];
+    Node* prev = find_last([&](const T& value) { return compare(value, key); }, path);
+
+    // Среди равных ключей узлы индекса идут в том же порядке, что и элементы
+    for (size_t level = 0; level < levels; ++level) {
+        Index* x = path[level];
+        while (x->right && x->right->node != node && !compare(key, x->right->node->value)) x = x->right;
+        if (x->right && x->right->node == node) {
+            Index* removed = x->right;
+            x->right = removed->right;
+            index_traits::deallocate(*index_alloc, removed, 1);
+        }
     }
-    std::cout << std::endl;
+    while (top && !top->right) {
+        Index* down = top->down;
+        index_traits::deallocate(*index_alloc, top, 1);
+        top = down;
+        --levels;
+    }
+
+    if (pos.previous ? pos.previous->next == node : head == node) {
+        prev = pos.previous;
+    } else {
+        for (Node* current = prev ? prev->next : head; current != node; current = current->next) prev = current;
+    }
+    Node* next = node->next;
+    (prev ? prev->next : head) = next;
+    if (tail == node) tail = prev;
+    node_traits::destroy(alloc, node);
+    node_traits::deallocate(alloc, node, 1);
+    --count;
+    return iterator(next, prev);
 }
 
-template <typename T, typename Alloc>
-size_t MyContainer<T, Alloc>::size() const {
-    return count;
+template <typename T, typename Alloc, typename Compare>
+void MyContainer<T, Alloc, ordered_layout<Compare>>::free_index() noexcept {
+    if constexpr (!detail::has_bulk_release<index_allocator>::value) {
+        for (Index* level = top; level; ) {
+            Index* down = level->down;
+            for (Index* x = level; x; ) {
+                Index* right = x->right;
+                index_traits::deallocate(*index_alloc, x, 1);
+                x = right;
+            }
+            level = down;
+        }
+    }
+    top = nullptr;
+    levels = 0;
 }
 
-template <typename T, typename Alloc>
-bool MyContainer<T, Alloc>::empty() const {
-    return count == 0;
+template <typename T, typename Alloc, typename Compare>
+void MyContainer<T, Alloc, ordered_layout<Compare>>::clear() {
+    free_index();
+    constexpr bool bulk = detail::has_bulk_release<node_allocator>::value;
+    if (!bulk || !std::is_trivially_destructible<T>::value) {
+        for (Node* current = head; current; ) {
+            Node* next = current->next;
+            node_traits::destroy(alloc, current);
+            if (!bulk) node_traits::deallocate(alloc, current, 1);
+            current = next;
+        }
+    }
+    head = tail = nullptr;
+    count = 0;
+}
+
+template <typename T, typename Alloc, typename Compare>
+void MyContainer<T, Alloc, ordered_layout<Compare>>::print(std::ostream& os) const {
+    for (Node* current = head; current; current = current->next) {
+        os << current->value << " ";
+    }
+    os << std::endl;
 }
 
 // ВСПОМОГАТЕЛЬНЫЕ ФУНКЦИИ
 namespace detail {
+    constexpr int first_ten[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
     inline int factorial(int n) {
         int result = 1;
         for (int i = 2; i <= n; ++i) {
@@ -415,50 +2989,28 @@ namespace detail {
         return result;
     }
     
-    inline void fill_std_map(std::map<int, int>& map) {
+    // Таблица факториалов 0..9 в любом словаре с интерфейсом std::map
+    template <typename Map>
+    void fill_factorials(Map& map) {
         for (int i = 0; i < 10; ++i) {
             map[i] = factorial(i);
         }
     }
     
+    inline void fill_std_map(std::map<int, int>& map) {
+        fill_factorials(map);
+    }
+    
     inline void fill_custom_map(std::map<int, int, std::less<int>, 
                          allocator<std::pair<const int, int>, 10>>& map) {
-        for (int i = 0; i < 10; ++i) {
-            map[i] = factorial(i);
-        }
+        fill_factorials(map);
     }
     
     inline void fill_my_container(MyContainer<int>& container) {
-        for (int i = 0; i < 10; ++i) {
-            container.add(i);
-        }
+        container.append(std::begin(first_ten), std::end(first_ten));
     }
     
     inline void fill_my_container_with_alloc(MyContainer<int, allocator<int, 10>>& container) {
-        for (int i = 0; i < 10; ++i) {
-            container.add(i);
-        }
-    }
-    
-    template<typename MapType>
-    void print_map(const MapType& map, const std::string& container_name = "") {
-        std::cout << (container_name.empty() ? "Map" : container_name) << std::endl;
-        std::cout << "Содержимое:" << std::endl;
-        
-        for (const auto& pair : map) {
-            std::cout << "  " << pair.first << " " << pair.second << std::endl;
-        }
-        
-        std::cout << "Размер: " << map.size() << " элементов" << std::endl << std::endl;
-    }
-    
-    template<typename ContainerType>
-    void print_container(const ContainerType& container, const std::string& container_name = "") {
-        std::cout << (container_name.empty() ? "Container" : container_name) << std::endl;
-        std::cout << "Содержимое: ";
-        
-        container.print();
-        
-        std::cout << "Размер: " << container.size() << " элементов" << std::endl << std::endl;
+        container.append(std::begin(first_ten), std::end(first_ten));
     }
 }
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ПОТОКОБЕЗОПАСНЫЙ АЛЛОКАТОР
+// Каждый поток держит магазин свободных ячеек и обслуживает allocate(1)/deallocate(p, 1)
+// без синхронизации. Пустой магазин пополняется из общего пула под мьютексом,
+// переполненный сбрасывает половину в общий пул через lock-free стек.
+// Освобождение никогда не берет мьютекс, в том числе когда объект выделил другой поток.
+namespace detail {
+
+// Свободная ячейка хранит ссылку на следующую прямо в своей памяти
+struct free_slot {
+    free_slot* next;
+};
+
+// Общий пул ячеек одного размера для всех потоков процесса
+template <size_t slot_size, size_t slot_align, size_t init_size>
+class central_pool {
+private:
+    std::mutex mutex;
+    std::vector<void*> blocks;  // под мьютексом
+    free_slot* free_slots;      // под мьютексом: ячейки, готовые к раздаче
+    unsigned char* bump;        // под мьютексом: еще не розданный хвост последнего блока
+    size_t bump_left;
+
+    // Пачки, возвращенные потоками. Только push и exchange всего списка — ABA невозможна.
+    std::atomic<free_slot*> returned;
+
+    void add_block();
+
+public:
+    central_pool() : free_slots(nullptr), bump(nullptr), bump_left(0), returned(nullptr) {}
+    central_pool(const central_pool&) = delete;
+    central_pool& operator=(const central_pool&) = delete;
+
+    // Пул живет до конца процесса: объекты в статических контейнерах
+    // могут освобождаться после разрушения любых других статических объектов
+    static central_pool& instance();
+
+    // Выдает цепочку из count ячеек
+    free_slot* fetch(size_t count);
+    // Возвращает цепочку head..tail, lock-free
+    void give_back(free_slot* head, free_slot* tail) noexcept;
+
+    size_t get_block_count();
+};
+
+// Магазин ячеек одного потока
+template <typename Central>
+class thread_cache {
+private:
+    Central& central;
+    free_slot* head;
+    size_t count;
+
+    void drain(size_t n) noexcept;
+
+public:
+    static constexpr size_t magazine_size = 64;
+
+    explicit thread_cache(Central& central) : central(central), head(nullptr), count(0) {}
+    thread_cache(const thread_cache&) = delete;
+    thread_cache& operator=(const thread_cache&) = delete;
+    ~thread_cache();
+
+    void* pop();
+    void push(void* p) noexcept;
+};
+
+// Реализация общего пула
+template <size_t slot_size, size_t slot_align, size_t init_size>
+central_pool<slot_size, slot_align, init_size>& central_pool<slot_size, slot_align, init_size>::instance()
+{
+    static central_pool* pool = new central_pool();
+    return *pool;
+}
+
+template <size_t slot_size, size_t slot_align, size_t init_size>
+void central_pool<slot_size, slot_align, init_size>::add_block()
+{
+    blocks.reserve(blocks.size() + 1);
+    bump = static_cast<unsigned char*>(::operator new(slot_size * init_size, std::align_val_t(slot_align)));
+    bump_left = init_size;
+    blocks.push_back(bump);
+}
+
+template <size_t slot_size, size_t slot_align, size_t init_size>
+free_slot* central_pool<slot_size, slot_align, init_size>::fetch(size_t count)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    free_slot* chain = nullptr;
+    for (size_t got = 0; got < count; ++got) {
+        if (!free_slots) {
+            free_slots = returned.exchange(nullptr, std::memory_order_acquire);
+        }
+        free_slot* s;
+        if (free_slots) {
+            s = free_slots;
+            free_slots = s->next;
+        } else {
+            if (!bump_left) {
+                try {
+                    add_block();
+                } catch (...) {
+                    // Уже собранные ячейки возвращаются в пул
+                    while (chain) {
+                        free_slot* next = chain->next;
+                        chain->next = free_slots;
+                        free_slots = chain;
+                        chain = next;
+                    }
+                    throw;
+                }
+            }
+            s = reinterpret_cast<free_slot*>(bump);
+            bump += slot_size;
+            --bump_left;
+        }
+        s->next = chain;
+        chain = s;
+    }
+    return chain;
+}
+
+template <size_t slot_size, size_t slot_align, size_t init_size>
+void central_pool<slot_size, slot_align, init_size>::give_back(free_slot* head, free_slot* tail) noexcept
+{
+    tail->next = returned.load(std::memory_order_relaxed);
+    while (!returned.compare_exchange_weak(tail->next, head,
+                                           std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+template <size_t slot_size, size_t slot_align, size_t init_size>
+size_t central_pool<slot_size, slot_align, init_size>::get_block_count()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return blocks.size();
+}
+
+// Реализация магазина
+template <typename Central>
+thread_cache<Central>::~thread_cache()
+{
+    if (count) drain(count);
+}
+
+template <typename Central>
+void* thread_cache<Central>::pop()
+{
+    if (!head) {
+        head = central.fetch(magazine_size / 2);
+        count = magazine_size / 2;
+    }
+    free_slot* s = head;
+    head = s->next;
+    --count;
+    return s;
+}
+
+template <typename Central>
+void thread_cache<Central>::push(void* p) noexcept
+{
+    free_slot* s = static_cast<free_slot*>(p);
+    s->next = head;
+    head = s;
+    if (++count >= magazine_size) drain(magazine_size / 2);
+}
+
+// Отдает n ячеек с головы магазина в общий пул
+template <typename Central>
+void thread_cache<Central>::drain(size_t n) noexcept
+{
+    free_slot* first = head;
+    free_slot* last = head;
+    for (size_t i = 1; i < n; ++i) {
+        last = last->next;
+    }
+    head = last->next;
+    count -= n;
+    central.give_back(first, last);
+}
+
+}  // namespace detail
+
+template <typename T, size_t init_size = 256>
+class concurrent_allocator {
+private:
+    // Ячейка вмещает ссылку свободного списка и выровнена под T
+    static constexpr size_t slot_align = alignof(T) > alignof(detail::free_slot) ? alignof(T) : alignof(detail::free_slot);
+    static constexpr size_t slot_size = ((sizeof(T) > sizeof(detail::free_slot) ? sizeof(T) : sizeof(detail::free_slot))
+                                         + slot_align - 1) & ~(slot_align - 1);
+
+    using central_type = detail::central_pool<slot_size, slot_align, init_size>;
+    using cache_type = detail::thread_cache<central_type>;
+
+    static cache_type& local_cache();
+
+public:
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    // Все экземпляры работают с одним пулом процесса
+    using is_always_equal = std::true_type;
+
+    template<typename U>
+    struct rebind {
+        using other = concurrent_allocator<U, init_size>;
+    };
+
+    concurrent_allocator() noexcept = default;
+    template <typename U>
+    concurrent_allocator(const concurrent_allocator<U, init_size>&) noexcept {}
+
+    T* allocate(size_t n);
+    void deallocate(T* p, size_t n) noexcept;
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        ::new((void*)p) U(std::forward<Args>(args)...);
+    }
+
+    template<typename U>
+    void destroy(U* p) noexcept {
+        p->~U();
+    }
+
+    size_t max_size() const noexcept { return static_cast<size_t>(-1) / sizeof(T); }
+
+    template<typename U>
+    bool operator==(const concurrent_allocator<U, init_size>&) const noexcept { return true; }
+
+    template<typename U>
+    bool operator!=(const concurrent_allocator<U, init_size>&) const noexcept { return false; }
+
+    // Блоков в общем пуле для ячеек типа T
+    static size_t get_block_count() { return central_type::instance().get_block_count(); }
+};
+
+template <typename T, size_t init_size>
+typename concurrent_allocator<T, init_size>::cache_type& concurrent_allocator<T, init_size>::local_cache()
+{
+    thread_local cache_type cache(central_type::instance());
+    return cache;
+}
+
+template <typename T, size_t init_size>
+T* concurrent_allocator<T, init_size>::allocate(size_t n)
+{
+    if (n == 0) return nullptr;
+    if (n > max_size()) throw std::bad_alloc();
+    // Массивы идут мимо пула
+    if (n > 1) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+    }
+    return static_cast<T*>(local_cache().pop());
+}
+
+template <typename T, size_t init_size>
+void concurrent_allocator<T, init_size>::deallocate(T* p, size_t n) noexcept
+{
+    if (!p || n == 0) return;
+    if (n > 1) {
+        ::operator delete(p, std::align_val_t(alignof(T)));
+        return;
+    }
+    local_cache().push(p);
+}
@@ -0,0 +1,795 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "bitmap.h"
+#include "common.h"
+
+// ПЛОСКИЙ СЛОВАРЬ
+// Ключи и значения лежат в двух отсортированных массивах, выделенных аллокатором словаря
+// (rebind к Key и T): поиск читает подряд только массив ключей. Интерфейс повторяет std::map,
+// поэтому словарь подставляется вместо него через typedef, с теми же параметрами шаблона.
+// Отличия от std::map: разыменование итератора дает пару ссылок std::pair<const Key&, T&>,
+// вставка и удаление сдвигают хвост массивов за O(n) и делают итераторы недействительными.
+
+// Метка конструктора из диапазона, уже отсортированного по ключу и без повторов
+struct sorted_unique_t {
+    explicit sorted_unique_t() = default;
+};
+inline constexpr sorted_unique_t sorted_unique{};
+
+namespace detail {
+
+// Окно, в котором линейный проход быстрее дальнейшего деления пополам
+constexpr size_t linear_search_window = 16;
+
+template <typename Key, typename Compare>
+struct is_plain_less : std::false_type {};
+template <typename Key>
+struct is_plain_less<Key, std::less<Key>> : std::true_type {};
+template <typename Key>
+struct is_plain_less<Key, std::less<>> : std::true_type {};
+
+// Число ключей меньше key среди n отсортированных: по 4 сравнения за инструкцию
+inline size_t count_less(const std::int32_t* keys, size_t n, std::int32_t key) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i needle = _mm_set1_epi32(key);
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(v, needle))));
+        // Ключи отсортированы: меньшие key образуют префикс
+        if (mask != 0xF) return i + bitmap::ctz(~bitmap::word_t(mask));
+    }
+#endif
+    while (i < n && keys[i] < key) ++i;
+    return i;
+}
+
+// Индекс первого ключа, не меньшего key
+template <typename Key, typename K, typename Compare>
+size_t flat_lower_bound(const Key* keys, size_t n, const K& key, const Compare& compare) {
+    if constexpr (std::is_arithmetic<Key>::value && std::is_arithmetic<K>::value) {
+        // Деление пополам без ветвлений: выбор половины компилируется в cmov.
+        // Ответ всегда в [base, base + n].
+        const Key* base = keys;
+        while (n > linear_search_window) {
+            size_t half = n / 2;
+            base = compare(base[half - 1], key) ? base + half : base;
+            n -= half;
+        }
+        if constexpr (std::is_same<Key, std::int32_t>::value && std::is_same<K, std::int32_t>::value &&
+                      is_plain_less<Key, Compare>::value) {
+            return static_cast<size_t>(base - keys) + count_less(base, n, key);
+        } else {
+            size_t i = 0;
+            while (i < n && compare(base[i], key)) ++i;
+            return static_cast<size_t>(base - keys) + i;
+        }
+    } else {
+        return static_cast<size_t>(std::lower_bound(keys, keys + n, key, compare) - keys);
+    }
+}
+
+}  // namespace detail
+
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Alloc = std::allocator<std::pair<const Key, T>>>
+class flat_map {
+private:
+    using key_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<Key>;
+    using key_traits = std::allocator_traits<key_allocator>;
+    using mapped_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+    using mapped_traits = std::allocator_traits<mapped_allocator>;
+
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<Key, T>;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::pair<const Key&, T&>;
+    using const_reference = std::pair<const Key&, const T&>;
+
+    // Сравнение пар по ключу, как у std::map
+    class value_compare {
+    private:
+        friend class flat_map;
+        Compare compare;
+        explicit value_compare(const Compare& compare) : compare(compare) {}
+
+    public:
+        bool operator()(const_reference a, const_reference b) const { return compare(a.first, b.first); }
+    };
+
+    // ИТЕРАТОР: пара указателей в массивы ключей и значений, произвольный доступ
+    template <bool Const>
+    class basic_iterator {
+    private:
+        friend class flat_map;
+        using mapped_pointer = std::conditional_t<Const, const T*, T*>;
+        const Key* key;
+        mapped_pointer mapped;
+
+        basic_iterator(const Key* key, mapped_pointer mapped) : key(key), mapped(mapped) {}
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = flat_map::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, flat_map::const_reference, flat_map::reference>;
+
+        // operator-> возвращает пару ссылок по значению
+        struct pointer {
+            reference ref;
+            const reference* operator->() const { return &ref; }
+        };
+
+        basic_iterator() : key(nullptr), mapped(nullptr) {}
+        // Изменяемый итератор приводится к константному
+        template <bool WasConst, typename = std::enable_if_t<Const && !WasConst>>
+        basic_iterator(const basic_iterator<WasConst>& other) : key(other.key), mapped(other.mapped) {}
+
+        reference operator*() const { return reference(*key, *mapped); }
+        pointer operator->() const { return pointer{**this}; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        basic_iterator& operator++() { ++key; ++mapped; return *this; }
+        basic_iterator operator++(int) { basic_iterator old = *this; ++*this; return old; }
+        basic_iterator& operator--() { --key; --mapped; return *this; }
+        basic_iterator operator--(int) { basic_iterator old = *this; --*this; return old; }
+        basic_iterator& operator+=(difference_type n) { key += n; mapped += n; return *this; }
+        basic_iterator& operator-=(difference_type n) { key -= n; mapped -= n; return *this; }
+        basic_iterator operator+(difference_type n) const { return basic_iterator(key + n, mapped + n); }
+        basic_iterator operator-(difference_type n) const { return basic_iterator(key - n, mapped - n); }
+        friend basic_iterator operator+(difference_type n, const basic_iterator& it) { return it + n; }
+        difference_type operator-(const basic_iterator& other) const { return key - other.key; }
+
+        bool operator==(const basic_iterator& other) const { return key == other.key; }
+        bool operator!=(const basic_iterator& other) const { return key != other.key; }
+        bool operator<(const basic_iterator& other) const { return key < other.key; }
+        bool operator>(const basic_iterator& other) const { return key > other.key; }
+        bool operator<=(const basic_iterator& other) const { return key <= other.key; }
+        bool operator>=(const basic_iterator& other) const { return key >= other.key; }
+
+        template <bool>
+        friend class basic_iterator;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+private:
+    Key* keys;
+    T* values;
+    size_t used;
+    size_t capacity_;
+    Compare compare;
+    key_allocator key_alloc;
+    mapped_allocator mapped_alloc;
+
+    // Индекс первого ключа, не меньшего key
+    template <typename K>
+    size_t lower_index(const K& key) const { return detail::flat_lower_bound(keys, used, key, compare); }
+    template <typename K>
+    bool matches(size_t index, const K& key) const { return index < used && !compare(key, keys[index]); }
+
+    iterator at_index(size_t index) { return iterator(keys + index, values + index); }
+    const_iterator at_index(size_t index) const { return const_iterator(keys + index, values + index); }
+
+    // Вставка на место index, ключ и значение строятся из аргументов
+    template <typename K, typename... Args>
+    iterator insert_at(size_t index, K&& key, Args&&... args);
+    // Элемент в свободное место за последним, место должно быть
+    template <typename K, typename... Args>
+    void construct_back(K&& key, Args&&... args);
+    void erase_at(size_t index, size_t n);
+    // Новые массивы на new_capacity элементов, старые элементы переносятся
+    void reallocate(size_t new_capacity);
+    void release() noexcept;
+    // Забирает массивы other, аллокаторы не трогает
+    void steal(flat_map& other) noexcept;
+    void append_copy(const flat_map& other);
+    // Заменяет содержимое упорядоченными парами без повторов
+    template <typename Pairs>
+    void assign_sorted(Pairs& pairs);
+    // Сортирует пары по ключу, из равных оставляет первую
+    template <typename Pairs>
+    void sort_unique(Pairs& pairs) const;
+
+public:
+    // Аллокаторы строятся по умолчанию: пустой словарь не заводит арену, а аллокатор
+    // значений связывается с аллокатором ключей при первом выделении
+    flat_map();
+    explicit flat_map(const Compare& compare, const Alloc& alloc = Alloc());
+    explicit flat_map(const Alloc& alloc) : flat_map(Compare(), alloc) {}
+    // Из произвольного диапазона пар: сортировка и удаление повторов за O(n log n)
+    template <typename InputIt, typename = detail::iterator_category_t<InputIt>>
+    flat_map(InputIt first, InputIt last, const Compare& compare = Compare(), const Alloc& alloc = Alloc());
+    // Из отсортированного диапазона без повторов: одно копирование за O(n)
+    template <typename InputIt, typename = detail::iterator_category_t<InputIt>>
+    flat_map(sorted_unique_t, InputIt first, InputIt last, const Compare& compare = Compare(), const Alloc& alloc = Alloc());
+    flat_map(std::initializer_list<value_type> values, const Compare& compare = Compare(), const Alloc& alloc = Alloc()) :
+        flat_map(values.begin(), values.end(), compare, alloc) {}
+    flat_map(const flat_map& other);
+    flat_map(flat_map&& other) noexcept;
+    ~flat_map() { release(); }
+
+    flat_map& operator=(const flat_map& other);
+    flat_map& operator=(flat_map&& other)
+        noexcept(key_traits::propagate_on_container_move_assignment::value || key_traits::is_always_equal::value);
+    flat_map& operator=(std::initializer_list<value_type> values);
+
+    // Доступ
+    T& operator[](const Key& key) { return try_emplace(key).first->second; }
+    T& operator[](Key&& key) { return try_emplace(std::move(key)).first->second; }
+    T& at(const Key& key);
+    const T& at(const Key& key) const;
+
+    // Итераторы
+    iterator begin() noexcept { return at_index(0); }
+    iterator end() noexcept { return at_index(used); }
+    const_iterator begin() const noexcept { return at_index(0); }
+    const_iterator end() const noexcept { return at_index(used); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    // Размер
+    bool empty() const noexcept { return used == 0; }
+    size_t size() const noexcept { return used; }
+    size_t max_size() const noexcept { return key_traits::max_size(key_alloc); }
+    size_t capacity() const noexcept { return capacity_; }
+    void reserve(size_t n) { if (n > capacity_) reallocate(n); }
+    void shrink_to_fit() { if (used < capacity_) reallocate(used); }
+
+    // Изменение. Вставка и удаление сдвигают хвост: O(log n) поиск и O(n) перенос
+    void clear() noexcept;
+    std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+    std::pair<iterator, bool> insert(value_type&& value) { return try_emplace(std::move(value.first), std::move(value.second)); }
+    template <typename P, typename = std::enable_if_t<std::is_constructible<value_type, P&&>::value>>
+    std::pair<iterator, bool> insert(P&& value) { return emplace(std::forward<P>(value)); }
+    iterator insert(const_iterator, const value_type& value) { return insert(value).first; }
+    // Пачка пар: слияние с имеющимися за O((n + m) log(n + m)), имеющиеся ключи не заменяются
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last);
+    void insert(std::initializer_list<value_type> values) { insert(values.begin(), values.end()); }
+    // Упорядоченная пачка без повторов: один резерв и одно слияние с хвоста за O(n + m)
+    template <typename InputIt>
+    void insert(sorted_unique_t, InputIt first, InputIt last);
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args);
+    template <typename... Args>
+    iterator emplace_hint(const_iterator, Args&&... args) { return emplace(std::forward<Args>(args)...).first; }
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args);
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const Key& key, M&& value);
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(Key&& key, M&& value);
+    iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+    size_t erase(const Key& key);
+    // Аллокаторы меняются, только если это разрешает propagate_on_container_swap
+    void swap(flat_map& other) noexcept;
+
+    // Поиск
+    template <typename K = Key>
+    iterator find(const K& key);
+    template <typename K = Key>
+    const_iterator find(const K& key) const;
+    size_t count(const Key& key) const { return matches(lower_index(key), key) ? 1 : 0; }
+    template <typename K = Key>
+    bool contains(const K& key) const { return matches(lower_index(key), key); }
+    template <typename K = Key>
+    iterator lower_bound(const K& key) { return at_index(lower_index(key)); }
+    template <typename K = Key>
+    const_iterator lower_bound(const K& key) const { return at_index(lower_index(key)); }
+    template <typename K = Key>
+    iterator upper_bound(const K& key);
+    template <typename K = Key>
+    const_iterator upper_bound(const K& key) const;
+    template <typename K = Key>
+    std::pair<iterator, iterator> equal_range(const K& key) { return {lower_bound(key), upper_bound(key)}; }
+    template <typename K = Key>
+    std::pair<const_iterator, const_iterator> equal_range(const K& key) const { return {lower_bound(key), upper_bound(key)}; }
+
+    // Наблюдатели
+    key_compare key_comp() const { return compare; }
+    value_compare value_comp() const { return value_compare(compare); }
+    Alloc get_allocator() const { return Alloc(key_alloc); }
+    // Массив ключей: удобен для собственного поиска и проверок раскладки
+    const Key* key_data() const noexcept { return keys; }
+    const T* mapped_data() const noexcept { return values; }
+};
+
+// Реализация плоского словаря
+template <typename Key, typename T, typename Compare, typename Alloc>
+flat_map<Key, T, Compare, Alloc>::flat_map() :
+    keys(nullptr), values(nullptr), used(0), capacity_(0), compare(), key_alloc(), mapped_alloc()
+{
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+flat_map<Key, T, Compare, Alloc>::flat_map(const Compare& compare, const Alloc& alloc) :
+    keys(nullptr), values(nullptr), used(0), capacity_(0), compare(compare), key_alloc(alloc), mapped_alloc(alloc)
+{
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+template <typename InputIt, typename>
+flat_map<Key, T, Compare, Alloc>::flat_map(InputIt first, InputIt last, const Compare& compare, const Alloc& alloc) :
+    flat_map(compare, alloc)
+{
+    insert(first, last);
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+template <typename InputIt, typename>
+flat_map<Key, T, Compare, Alloc>::flat_map(sorted_unique_t, InputIt first, InputIt last, const Compare& compare, const Alloc& alloc) :
+    flat_map(compare, alloc)
+{
+    if constexpr (detail::is_forward_iterator<InputIt>) {
+        reserve(static_cast<size_t>(std::distance(first, last)));
+    }
+    try {
+        for (; first != last; ++first) insert_at(used, first->first, first->second);
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+flat_map<Key, T, Compare, Alloc>::flat_map(const flat_map& other) :
+    keys(nullptr), values(nullptr), used(0), capacity_(0), compare(other.compare),
+    key_alloc(key_traits::select_on_container_copy_construction(other.key_alloc)),
+    mapped_alloc(mapped_traits::select_on_container_copy_construction(other.mapped_alloc))
+{
+    try {
+        append_copy(other);
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+flat_map<Key, T, Compare, Alloc>::flat_map(flat_map&& other) noexcept :
+    keys(other.keys), values(other.values), used(other.used), capacity_(other.capacity_), compare(other.compare),
+    key_alloc(std::move(other.key_alloc)), mapped_alloc(std::move(other.mapped_alloc))
+{
+    other.keys = nullptr;
+    other.values = nullptr;
+    other.used = other.capacity_ = 0;
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+void flat_map<Key, T, Compare, Alloc>::steal(flat_map& other) noexcept {
+    keys = other.keys;
+    values = other.values;
+    used = other.used;
+    capacity_ = other.capacity_;
+    other.keys = nullptr;
+    other.values = nullptr;
+    other.used = other.capacity_ = 0;
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+void flat_map<Key, T, Compare, Alloc>::append_copy(const flat_map& other) {
+    reserve(used + other.used);
+    for (size_t i = 0; i < other.used; ++i) insert_at(used, other.keys[i], other.values[i]);
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+flat_map<Key, T, Compare, Alloc>& flat_map<Key, T, Compare, Alloc>::operator=(const flat_map& other) {
+    if (this == &other) return *this;
+    release();
+    compare = other.compare;
+    if constexpr (key_traits::propagate_on_container_copy_assignment::value) {
+        key_alloc = other.key_alloc;
+        mapped_alloc = other.mapped_alloc;
+    }
+    append_copy(other);
+    return *this;
+}
+
+// Массивы можно забрать, если их освобождают наши аллокаторы,
+// иначе элементы переносятся по одному в новые массивы
+template <typename Key, typename T, typename Compare, typename Alloc>
+flat_map<Key, T, Compare, Alloc>& flat_map<Key, T, Compare, Alloc>::operator=(flat_map&& other)
+    noexcept(key_traits::propagate_on_container_move_assignment::value || key_traits::is_always_equal::value)
+{
+    if (this == &other) return *this;
+    release();
+    compare = other.compare;
+    if constexpr (key_traits::propagate_on_container_move_assignment::value) {
+        key_alloc = std::move(other.key_alloc);
+        mapped_alloc = std::move(other.mapped_alloc);
+        steal(other);
+    } else {
+        if (key_alloc == other.key_alloc && mapped_alloc == other.mapped_alloc) {
+            steal(other);
+        } else {
+            reserve(other.used);
+            for (size_t i = 0; i < other.used; ++i) insert_at(used, std::move(other.keys[i]), std::move(other.values[i]));
+            other.clear();
+        }
+    }
+    return *this;
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+flat_map<Key, T, Compare, Alloc>& flat_map<Key, T, Compare, Alloc>::operator=(std::initializer_list<value_type> values) {
+    clear();
+    insert(values);
+    return *this;
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+void flat_map<Key, T, Compare, Alloc>::swap(flat_map& other) noexcept {
+    using std::swap;
+    swap(keys, other.keys);
+    swap(values, other.values);
+    swap(used, other.used);
+    swap(capacity_, other.capacity_);
+    swap(compare, other.compare);
+    if constexpr (key_traits::propagate_on_container_swap::value) {
+        swap(key_alloc, other.key_alloc);
+        swap(mapped_alloc, other.mapped_alloc);
+    }
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+T& flat_map<Key, T, Compare, Alloc>::at(const Key& key) {
+    size_t index = lower_index(key);
+    if (!matches(index, key)) throw std::out_of_range("flat_map::at");
+    return values[index];
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+const T& flat_map<Key, T, Compare, Alloc>::at(const Key& key) const {
+    size_t index = lower_index(key);
+    if (!matches(index, key)) throw std::out_of_range("flat_map::at");
+    return values[index];
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+template <typename K>
+typename flat_map<Key, T, Compare, Alloc>::iterator flat_map<Key, T, Compare, Alloc>::find(const K& key) {
+    size_t index = lower_index(key);
+    return matches(index, key) ? at_index(index) : end();
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+template <typename K>
+typename flat_map<Key, T, Compare, Alloc>::const_iterator flat_map<Key, T, Compare, Alloc>::find(const K& key) const {
+    size_t index = lower_index(key);
+    return matches(index, key) ? at_index(index) : end();
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+template <typename K>
+typename flat_map<Key, T, Compare, Alloc>::iterator flat_map<Key, T, Compare, Alloc>::upper_bound(const K& key) {
+    size_t index = lower_index(key);
+    return at_index(matches(index, key) ? index + 1 : index);
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+template <typename K>
+typename flat_map<Key, T, Compare, Alloc>::const_iterator flat_map<Key, T, Compare, Alloc>::upper_bound(const K& key) const {
+    size_t index = lower_index(key);
+    return at_index(matches(index, key) ? index + 1 : index);
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+template <typename K, typename... Args>
+std::pair<typename flat_map<Key, T, Compare, Alloc>::iterator, bool>
+flat_map<Key, T, Compare, Alloc>::try_emplace(K&& key, Args&&... args) {
+    size_t index = lower_index(key);
+    if (matches(index, key)) return {at_index(index), false};
+    return {insert_at(index, std::forward<K>(key), std::forward<Args>(args)...), true};
+}
+
+// Пара строится заранее: ключ известен только после конструирования
+template <typename Key, typename T, typename Compare, typename Alloc>
+template <typename... Args>
+std::pair<typename flat_map<Key, T, Compare, Alloc>::iterator, bool>
+flat_map<Key, T, Compare, Alloc>::emplace(Args&&... args) {
+    value_type value(std::forward<Args>(args)...);
+    return try_emplace(std::move(value.first), std::move(value.second));
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+template <typename M>
+std::pair<typename flat_map<Key, T, Compare, Alloc>::iterator, bool>
+flat_map<Key, T, Compare, Alloc>::insert_or_assign(const Key& key, M&& value) {
+    size_t index = lower_index(key);
+    if (matches(index, key)) {
+        values[index] = std::forward<M>(value);
+        return {at_index(index), false};
+    }
+    return {insert_at(index, key, std::forward<M>(value)), true};
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+template <typename M>
+std::pair<typename flat_map<Key, T, Compare, Alloc>::iterator, bool>
+flat_map<Key, T, Compare, Alloc>::insert_or_assign(Key&& key, M&& value) {
+    size_t index = lower_index(key);
+    if (matches(index, key)) {
+        values[index] = std::forward<M>(value);
+        return {at_index(index), false};
+    }
+    return {insert_at(index, std::move(key), std::forward<M>(value)), true};
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+template <typename InputIt>
+void flat_map<Key, T, Compare, Alloc>::insert(InputIt first, InputIt last) {
+    using pair_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<value_type>;
+    std::vector<value_type, pair_allocator> pairs{pair_allocator(key_alloc)};
+    if constexpr (detail::is_forward_iterator<InputIt>) {
+        pairs.reserve(used + static_cast<size_t>(std::distance(first, last)));
+    }
+    // Имеющиеся пары идут первыми и остаются при равных ключах
+    for (size_t i = 0; i < used; ++i) pairs.emplace_back(keys[i], values[i]);
+    for (; first != last; ++first) pairs.emplace_back(first->first, first->second);
+    sort_unique(pairs);
+    assign_sorted(pairs);
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+template <typename InputIt>
+void flat_map<Key, T, Compare, Alloc>::insert(sorted_unique_t, InputIt first, InputIt last) {
+    // Слияние переносит элементы на месте и не должно прерываться исключением
+    if constexpr (!std::is_nothrow_move_constructible<Key>::value || !std::is_nothrow_move_assignable<Key>::value ||
+                  !std::is_nothrow_move_constructible<T>::value || !std::is_nothrow_move_assignable<T>::value) {
+        insert(first, last);
+    } else {
+        // Проход по обеим последовательностям: новые ключи копируются в буфер, имеющиеся пропускаются
+        using pair_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<std::pair<Key, T>>;
+        std::vector<std::pair<Key, T>, pair_allocator> fresh{pair_allocator(key_alloc)};
+        if constexpr (detail::is_forward_iterator<InputIt>) {
+            fresh.reserve(static_cast<size_t>(std::distance(first, last)));
+        }
+        size_t i = 0;
+        for (; first != last; ++first) {
+            while (i < used && compare(keys[i], first->first)) ++i;
+            if (i < used && !compare(first->first, keys[i])) continue;
+            fresh.emplace_back(first->first, first->second);
+        }
+        if (fresh.empty()) return;
+        reserve(used + fresh.size());
+
+        // Слияние с конца: места за used строятся, остальные присваиваются
+        auto place = [this](size_t pos, Key&& key, T&& value) noexcept {
+            if (pos >= used) {
+                key_traits::construct(key_alloc, keys + pos, std::move(key));
+                mapped_traits::construct(mapped_alloc, values + pos, std::move(value));
+            } else {
+                keys[pos] = std::move(key);
+                values[pos] = std::move(value);
+            }
+        };
+        size_t existing = used;
+        size_t pending = fresh.size();
+        for (size_t out = used + pending; pending > 0; --out) {
+            if (existing > 0 && compare(fresh[pending - 1].first, keys[existing - 1])) {
+                --existing;
+                place(out - 1, std::move(keys[existing]), std::move(values[existing]));
+            } else {
+                --pending;
+                place(out - 1, std::move(fresh[pending].first), std::move(fresh[pending].second));
+            }
+        }
+        used += fresh.size();
+    }
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+template <typename Pairs>
+void flat_map<Key, T, Compare, Alloc>::sort_unique(Pairs& pairs) const {
+    auto by_key = [this](const value_type& a, const value_type& b) { return compare(a.first, b.first); };
+    if (!std::is_sorted(pairs.begin(), pairs.end(), by_key)) {
+        std::stable_sort(pairs.begin(), pairs.end(), by_key);
+    }
+    auto same_key = [this](const value_type& a, const value_type& b) { return !compare(a.first, b.first) && !compare(b.first, a.first); };
+    pairs.erase(std::unique(pairs.begin(), pairs.end(), same_key), pairs.end());
+}
+
+// Пары уже содержат все элементы: старые массивы переиспользуются, если хватает места
+template <typename Key, typename T, typename Compare, typename Alloc>
+template <typename Pairs>
+void flat_map<Key, T, Compare, Alloc>::assign_sorted(Pairs& pairs) {
+    clear();
+    reserve(pairs.size());
+    for (auto& pair : pairs) insert_at(used, std::move(pair.first), std::move(pair.second));
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+template <typename K, typename... Args>
+typename flat_map<Key, T, Compare, Alloc>::iterator
+flat_map<Key, T, Compare, Alloc>::insert_at(size_t index, K&& key, Args&&... args) {
+    if (index == used && used < capacity_) {
+        construct_back(std::forward<K>(key), std::forward<Args>(args)...);
+        return at_index(index);
+    }
+
+    // Аргументы могут ссылаться на элементы словаря, поэтому элемент строится до
+    // переноса массивов и сдвига хвоста
+    Key new_key(std::forward<K>(key));
+    T new_value(std::forward<Args>(args)...);
+    if (used == capacity_) {
+        reallocate(capacity_ ? capacity_ * 2 : 4);
+    }
+    if (index == used) {
+        construct_back(std::move(new_key), std::move(new_value));
+        return at_index(index);
+    }
+    key_traits::construct(key_alloc, keys + used, std::move(keys[used - 1]));
+    try {
+        mapped_traits::construct(mapped_alloc, values + used, std::move(values[used - 1]));
+    } catch (...) {
+        key_traits::destroy(key_alloc, keys + used);
+        throw;
+    }
+    ++used;
+    std::move_backward(keys + index, keys + used - 2, keys + used - 1);
+    std::move_backward(values + index, values + used - 2, values + used - 1);
+    keys[index] = std::move(new_key);
+    values[index] = std::move(new_value);
+    return at_index(index);
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+template <typename K, typename... Args>
+void flat_map<Key, T, Compare, Alloc>::construct_back(K&& key, Args&&... args) {
+    key_traits::construct(key_alloc, keys + used, std::forward<K>(key));
+    try {
+        mapped_traits::construct(mapped_alloc, values + used, std::forward<Args>(args)...);
+    } catch (...) {
+        key_traits::destroy(key_alloc, keys + used);
+        throw;
+    }
+    ++used;
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+void flat_map<Key, T, Compare, Alloc>::erase_at(size_t index, size_t n) {
+    std::move(keys + index + n, keys + used, keys + index);
+    std::move(values + index + n, values + used, values + index);
+    for (size_t i = used - n; i < used; ++i) {
+        key_traits::destroy(key_alloc, keys + i);
+        mapped_traits::destroy(mapped_alloc, values + i);
+    }
+    used -= n;
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+typename flat_map<Key, T, Compare, Alloc>::iterator flat_map<Key, T, Compare, Alloc>::erase(const_iterator pos) {
+    size_t index = static_cast<size_t>(pos.key - keys);
+    erase_at(index, 1);
+    return at_index(index);
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+typename flat_map<Key, T, Compare, Alloc>::iterator
+flat_map<Key, T, Compare, Alloc>::erase(const_iterator first, const_iterator last) {
+    size_t index = static_cast<size_t>(first.key - keys);
+    erase_at(index, static_cast<size_t>(last - first));
+    return at_index(index);
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+size_t flat_map<Key, T, Compare, Alloc>::erase(const Key& key) {
+    size_t index = lower_index(key);
+    if (!matches(index, key)) return 0;
+    erase_at(index, 1);
+    return 1;
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+void flat_map<Key, T, Compare, Alloc>::reallocate(size_t new_capacity) {
+    Key* new_keys = new_capacity ? key_traits::allocate(key_alloc, new_capacity) : nullptr;
+    T* new_values = nullptr;
+    size_t moved = 0;
+    try {
+        // Без массива значений аллокатор значений берется у ключей: у словаря по умолчанию
+        // они строятся порознь, а память обоих массивов должна лежать в одной арене
+        if constexpr (std::is_copy_assignable<mapped_allocator>::value) {
+            if (!values && new_capacity) mapped_alloc = mapped_allocator(key_alloc);
+        }
+        if (new_capacity) new_values = mapped_traits::allocate(mapped_alloc, new_capacity);
+        for (; moved < used; ++moved) {
+            key_traits::construct(key_alloc, new_keys + moved, std::move_if_noexcept(keys[moved]));
+            try {
+                mapped_traits::construct(mapped_alloc, new_values + moved, std::move_if_noexcept(values[moved]));
+            } catch (...) {
+                key_traits::destroy(key_alloc, new_keys + moved);
+                throw;
+            }
+        }
+    } catch (...) {
+        for (size_t i = 0; i < moved; ++i) {
+            key_traits::destroy(key_alloc, new_keys + i);
+            mapped_traits::destroy(mapped_alloc, new_values + i);
+        }
+        if (new_values) mapped_traits::deallocate(mapped_alloc, new_values, new_capacity);
+        if (new_keys) key_traits::deallocate(key_alloc, new_keys, new_capacity);
+        throw;
+    }
+    size_t kept = used;
+    release();
+    keys = new_keys;
+    values = new_values;
+    used = kept;
+    capacity_ = new_capacity;
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+void flat_map<Key, T, Compare, Alloc>::clear() noexcept {
+    for (size_t i = 0; i < used; ++i) {
+        key_traits::destroy(key_alloc, keys + i);
+        mapped_traits::destroy(mapped_alloc, values + i);
+    }
+    used = 0;
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+void flat_map<Key, T, Compare, Alloc>::release() noexcept {
+    clear();
+    if (keys) key_traits::deallocate(key_alloc, keys, capacity_);
+    if (values) mapped_traits::deallocate(mapped_alloc, values, capacity_);
+    keys = nullptr;
+    values = nullptr;
+    capacity_ = 0;
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+bool operator==(const flat_map<Key, T, Compare, Alloc>& a, const flat_map<Key, T, Compare, Alloc>& b) {
+    if (a.size() != b.size()) return false;
+    return std::equal(a.key_data(), a.key_data() + a.size(), b.key_data()) &&
+           std::equal(a.mapped_data(), a.mapped_data() + a.size(), b.mapped_data());
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+bool operator!=(const flat_map<Key, T, Compare, Alloc>& a, const flat_map<Key, T, Compare, Alloc>& b) {
+    return !(a == b);
+}
+
+template <typename Key, typename T, typename Compare, typename Alloc>
+void swap(flat_map<Key, T, Compare, Alloc>& a, flat_map<Key, T, Compare, Alloc>& b) noexcept {
+    a.swap(b);
+}
+
+namespace detail {
+    // Таблица факториалов из fill_custom_map в плоском словаре: тот же аллокатор, другой typedef
+    using custom_flat_map = flat_map<int, int, std::less<int>, allocator<std::pair<const int, int>, 10>>;
+
+    inline void fill_custom_flat_map(custom_flat_map& map) {
+        fill_factorials(map);
+    }
+}
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// LOCK-FREE ПУЛ ЯЧЕЕК
+// Стек Трайбера свободных ячеек, общий для всех потоков. Вершина стека — 64-битное слово
+// «метка | номер ячейки + 1»: каждая успешная операция увеличивает метку, поэтому
+// ячейка, которую успели снять и вернуть между чтением и CAS, не ломает стек (ABA).
+// Ссылки на следующую ячейку лежат в отдельном массиве атомиков, а не в памяти объектов:
+// чтение устаревшей ссылки безопасно и не является гонкой данных.
+namespace detail {
+
+template <size_t slot_size, size_t slot_align, size_t init_size, size_t max_blocks = 4096>
+class lockfree_pool {
+private:
+    static constexpr std::uint32_t empty = 0;
+
+    // Блок выровнен на свой размер (степень двойки): начало блока по адресу ячейки
+    // находится маской, номер блока лежит в заголовке
+    struct block_header {
+        std::uint32_t index;
+    };
+
+    static constexpr size_t round_up(size_t value, size_t align) {
+        return (value + align - 1) / align * align;
+    }
+    static constexpr size_t next_pow2(size_t value) {
+        size_t result = 1;
+        while (result < value) result *= 2;
+        return result;
+    }
+
+    static constexpr size_t header_bytes = round_up(sizeof(block_header), slot_align);
+    static constexpr size_t block_bytes = next_pow2(header_bytes + slot_size * init_size);
+
+public:
+    // Ячеек в блоке: все, что поместилось после заголовка
+    static constexpr size_t slots_per_block = (block_bytes - header_bytes) / slot_size;
+
+private:
+    static_assert(static_cast<std::uint64_t>(max_blocks) * slots_per_block < (std::uint64_t(1) << 32) - 1,
+                  "slot index must fit into 32 bits");
+
+    std::atomic<std::uint64_t> head;
+    std::atomic<size_t> block_count;
+    std::atomic<unsigned char*> blocks[max_blocks];
+    std::atomic<std::atomic<std::uint32_t>*> links[max_blocks];
+
+    static std::uint64_t pack(std::uint64_t tag, std::uint32_t index_plus_one) {
+        return (tag << 32) | index_plus_one;
+    }
+    static std::uint32_t index_of(std::uint64_t top) { return static_cast<std::uint32_t>(top); }
+    static std::uint64_t tag_of(std::uint64_t top) { return top >> 32; }
+
+    std::atomic<std::uint32_t>& link(std::uint32_t index) const;
+    void* slot(std::uint32_t index) const;
+    std::uint32_t slot_index(void* p) const;
+
+    void push_chain(std::uint32_t first, std::uint32_t last) noexcept;
+    void* grow();
+
+public:
+    lockfree_pool();
+    lockfree_pool(const lockfree_pool&) = delete;
+    lockfree_pool& operator=(const lockfree_pool&) = delete;
+    ~lockfree_pool();
+
+    // Пул живет до конца процесса, как и общий пул concurrent_allocator
+    static lockfree_pool& instance();
+
+    void* allocate();
+    void deallocate(void* p) noexcept;
+
+    size_t get_block_count() const { return block_count.load(std::memory_order_acquire); }
+};
+
+template <size_t slot_size, size_t slot_align, size_t init_size, size_t max_blocks>
+lockfree_pool<slot_size, slot_align, init_size, max_blocks>::lockfree_pool() : head(pack(0, empty)), block_count(0)
+{
+    for (size_t i = 0; i < max_blocks; ++i) {
+        blocks[i].store(nullptr, std::memory_order_relaxed);
+        links[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template <size_t slot_size, size_t slot_align, size_t init_size, size_t max_blocks>
+lockfree_pool<slot_size, slot_align, init_size, max_blocks>::~lockfree_pool()
+{
+    size_t count = block_count.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count && i < max_blocks; ++i) {
+        if (unsigned char* b = blocks[i].load(std::memory_order_relaxed)) {
+            ::operator delete(b, std::align_val_t(block_bytes));
+        }
+        delete[] links[i].load(std::memory_order_relaxed);
+    }
+}
+
+template <size_t slot_size, size_t slot_align, size_t init_size, size_t max_blocks>
+lockfree_pool<slot_size, slot_align, init_size, max_blocks>& lockfree_pool<slot_size, slot_align, init_size, max_blocks>::instance()
+{
+    static lockfree_pool* pool = new lockfree_pool();
+    return *pool;
+}
+
+template <size_t slot_size, size_t slot_align, size_t init_size, size_t max_blocks>
+std::atomic<std::uint32_t>& lockfree_pool<slot_size, slot_align, init_size, max_blocks>::link(std::uint32_t index) const
+{
+    return links[index / slots_per_block].load(std::memory_order_acquire)[index % slots_per_block];
+}
+
+template <size_t slot_size, size_t slot_align, size_t init_size, size_t max_blocks>
+void* lockfree_pool<slot_size, slot_align, init_size, max_blocks>::slot(std::uint32_t index) const
+{
+    unsigned char* b = blocks[index / slots_per_block].load(std::memory_order_acquire);
+    return b + header_bytes + (index % slots_per_block) * slot_size;
+}
+
+template <size_t slot_size, size_t slot_align, size_t init_size, size_t max_blocks>
+std::uint32_t lockfree_pool<slot_size, slot_align, init_size, max_blocks>::slot_index(void* p) const
+{
+    std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(p);
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(addr & ~(std::uintptr_t(block_bytes) - 1));
+    const block_header* header = reinterpret_cast<const block_header*>(b);
+    size_t in_block = (static_cast<const unsigned char*>(p) - b - header_bytes) / slot_size;
+    return static_cast<std::uint32_t>(header->index * slots_per_block + in_block);
+}
+
+// Кладет цепочку first -> ... -> last, уже связанную через link, на вершину стека
+template <size_t slot_size, size_t slot_align, size_t init_size, size_t max_blocks>
+void lockfree_pool<slot_size, slot_align, init_size, max_blocks>::push_chain(std::uint32_t first, std::uint32_t last) noexcept
+{
+    std::atomic<std::uint32_t>& tail = link(last);
+    std::uint64_t top = head.load(std::memory_order_relaxed);
+    std::uint64_t desired;
+    do {
+        tail.store(index_of(top), std::memory_order_relaxed);
+        desired = pack(tag_of(top) + 1, first + 1);
+    } while (!head.compare_exchange_weak(top, desired, std::memory_order_release, std::memory_order_relaxed));
+}
+
+// Новый блок: первая ячейка уходит вызвавшему, остальные — в стек одной цепочкой.
+// Номер блока занимается только после выделения памяти: при нехватке памяти
+// block_count не растет и место в blocks не теряется.
+template <size_t slot_size, size_t slot_align, size_t init_size, size_t max_blocks>
+void* lockfree_pool<slot_size, slot_align, init_size, max_blocks>::grow()
+{
+    if (block_count.load(std::memory_order_relaxed) >= max_blocks) throw std::bad_alloc();
+    unsigned char* data = static_cast<unsigned char*>(::operator new(block_bytes, std::align_val_t(block_bytes)));
+    std::atomic<std::uint32_t>* next = new (std::nothrow) std::atomic<std::uint32_t>[slots_per_block]();
+    if (!next) {
+        ::operator delete(data, std::align_val_t(block_bytes));
+        throw std::bad_alloc();
+    }
+
+    size_t b = block_count.load(std::memory_order_relaxed);
+    do {
+        if (b >= max_blocks) {
+            delete[] next;
+            ::operator delete(data, std::align_val_t(block_bytes));
+            throw std::bad_alloc();
+        }
+    } while (!block_count.compare_exchange_weak(b, b + 1, std::memory_order_acq_rel, std::memory_order_relaxed));
+    reinterpret_cast<block_header*>(data)->index = static_cast<std::uint32_t>(b);
+
+    std::uint32_t first = static_cast<std::uint32_t>(b * slots_per_block);
+    for (size_t i = 1; i + 1 < slots_per_block; ++i) {
+        next[i].store(first + static_cast<std::uint32_t>(i) + 2, std::memory_order_relaxed);
+    }
+    links[b].store(next, std::memory_order_release);
+    blocks[b].store(data, std::memory_order_release);
+
+    if (slots_per_block > 1) {
+        push_chain(first + 1, first + static_cast<std::uint32_t>(slots_per_block) - 1);
+    }
+    return data + header_bytes;
+}
+
+template <size_t slot_size, size_t slot_align, size_t init_size, size_t max_blocks>
+void* lockfree_pool<slot_size, slot_align, init_size, max_blocks>::allocate()
+{
+    std::uint64_t top = head.load(std::memory_order_acquire);
+    while (index_of(top) != empty) {
+        std::uint32_t index = index_of(top) - 1;
+        // Ссылка может оказаться устаревшей, тогда CAS не пройдет из-за метки
+        std::uint32_t next = link(index).load(std::memory_order_relaxed);
+        if (head.compare_exchange_weak(top, pack(tag_of(top) + 1, next),
+                                       std::memory_order_acquire, std::memory_order_acquire)) {
+            return slot(index);
+        }
+    }
+    return grow();
+}
+
+template <size_t slot_size, size_t slot_align, size_t init_size, size_t max_blocks>
+void lockfree_pool<slot_size, slot_align, init_size, max_blocks>::deallocate(void* p) noexcept
+{
+    std::uint32_t index = slot_index(p);
+    push_chain(index, index);
+}
+
+}  // namespace detail
+
+// Аллокатор поверх lock-free пула: одиночные ячейки из общего стека,
+// массивы — напрямую из operator new
+template <typename T, size_t init_size = 256>
+class lockfree_allocator {
+private:
+    using pool_type = detail::lockfree_pool<sizeof(T), alignof(T), init_size>;
+
+public:
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    // Все экземпляры работают с одним пулом процесса
+    using is_always_equal = std::true_type;
+
+    template<typename U>
+    struct rebind {
+        using other = lockfree_allocator<U, init_size>;
+    };
+
+    lockfree_allocator() noexcept = default;
+    template <typename U>
+    lockfree_allocator(const lockfree_allocator<U, init_size>&) noexcept {}
+
+    T* allocate(size_t n);
+    void deallocate(T* p, size_t n) noexcept;
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        ::new((void*)p) U(std::forward<Args>(args)...);
+    }
+
+    template<typename U>
+    void destroy(U* p) noexcept {
+        p->~U();
+    }
+
+    size_t max_size() const noexcept { return static_cast<size_t>(-1) / sizeof(T); }
+
+    template<typename U>
+    bool operator==(const lockfree_allocator<U, init_size>&) const noexcept { return true; }
+
+    template<typename U>
+    bool operator!=(const lockfree_allocator<U, init_size>&) const noexcept { return false; }
+
+    static size_t get_block_count() { return pool_type::instance().get_block_count(); }
+};
+
+template <typename T, size_t init_size>
+T* lockfree_allocator<T, init_size>::allocate(size_t n)
+{
+    if (n == 0) return nullptr;
+    if (n > max_size()) throw std::bad_alloc();
+    if (n > 1) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+    }
+    return static_cast<T*>(pool_type::instance().allocate());
+}
+
+template <typename T, size_t init_size>
+void lockfree_allocator<T, init_size>::deallocate(T* p, size_t n) noexcept
+{
+    if (!p || n == 0) return;
+    if (n > 1) {
+        ::operator delete(p, std::align_val_t(alignof(T)));
+        return;
+    }
+    pool_type::instance().deallocate(p);
+}
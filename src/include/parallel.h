@@ -0,0 +1,222 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// ПАРАЛЛЕЛЬНЫЕ АЛГОРИТМЫ НАД MYCONTAINER
+// Контейнер делится на диапазоны через split_points, диапазоны обрабатываются
+// на потоках пула. Результаты совпадают с последовательным обходом:
+// find_if находит первый по порядку элемент, transform_reduce сворачивает
+// частичные результаты в порядке диапазонов (reduce должна быть ассоциативной).
+
+// ПУЛ ПОТОКОВ
+// Фиксированный набор рабочих потоков. run(n, task) раздает номера задач [0, n)
+// рабочим потокам и вызывающему, возвращается после выполнения всех задач.
+// Одновременно выполняется один run; вызывать run из задачи нельзя.
+class thread_pool {
+private:
+    // Текущая порция задач
+    struct batch {
+        std::function<void(size_t)> task;
+        size_t count;
+        std::atomic<size_t> next{0};
+        std::exception_ptr error;  // под mutex
+    };
+
+    std::vector<std::thread> workers;
+    std::mutex run_mutex;          // по одному run за раз
+    std::mutex mutex;
+    std::condition_variable wake;  // рабочим: новая порция или остановка
+    std::condition_variable idle;  // вызывающему: порция выполнена и рабочие ее отпустили
+    batch* current;                // под mutex
+    size_t generation;             // под mutex
+    size_t active;                 // под mutex: рабочие, держащие current
+    bool stopping;                 // под mutex
+
+    void work(batch& b);
+    void worker_loop();
+
+public:
+    // threads — число рабочих потоков помимо вызывающего
+    explicit thread_pool(size_t threads = default_threads());
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    ~thread_pool();
+
+    // Потоков, исполняющих задачи, вместе с вызывающим
+    size_t concurrency() const { return workers.size() + 1; }
+
+    // Первое исключение из задач пробрасывается вызывающему после завершения остальных
+    template <typename Task>
+    void run(size_t n, Task&& task);
+
+    static size_t default_threads() {
+        unsigned hardware = std::thread::hardware_concurrency();
+        return hardware > 1 ? hardware - 1 : 0;
+    }
+};
+
+inline thread_pool::thread_pool(size_t threads) :
+    current(nullptr), generation(0), active(0), stopping(false)
+{
+    workers.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) workers.emplace_back([this] { worker_loop(); });
+}
+
+inline thread_pool::~thread_pool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+// Забирает номера задач, пока они есть
+inline void thread_pool::work(batch& b) {
+    for (size_t i; (i = b.next.fetch_add(1, std::memory_order_relaxed)) < b.count; ) {
+        try {
+            b.task(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!b.error) b.error = std::current_exception();
+        }
+    }
+}
+
+inline void thread_pool::worker_loop() {
+    size_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [&] { return stopping || (current && generation != seen); });
+        if (stopping) return;
+        seen = generation;
+        batch* b = current;
+        ++active;
+        lock.unlock();
+        work(*b);
+        lock.lock();
+        if (--active == 0) idle.notify_all();
+    }
+}
+
+template <typename Task>
+void thread_pool::run(size_t n, Task&& task) {
+    if (!n) return;
+    if (workers.empty() || n == 1) {
+        for (size_t i = 0; i < n; ++i) task(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> run_lock(run_mutex);
+    batch b;
+    b.task = std::ref(task);
+    b.count = n;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current = &b;
+        ++generation;
+    }
+    wake.notify_all();
+    work(b);
+
+    // Порция живет на стеке: ждем, пока ее отпустят все рабочие
+    std::unique_lock<std::mutex> lock(mutex);
+    current = nullptr;
+    idle.wait(lock, [&] { return active == 0; });
+    if (b.error) std::rethrow_exception(b.error);
+}
+
+namespace parallel {
+
+// Диапазонов на поток: выравнивают нагрузку, если элементы обрабатываются неравномерно
+constexpr size_t segments_per_thread = 4;
+
+// Перегрузки для контейнеров выбираются только для типов с split_points
+template <typename Container>
+using splittable = decltype(std::declval<Container&>().split_points(size_t()));
+
+// Разбиение контейнера под пул
+template <typename Container>
+splittable<Container> split(thread_pool& pool, Container& container) {
+    return container.split_points(pool.concurrency() * segments_per_thread);
+}
+
+// ОБХОД
+// Перегрузки с bounds принимают готовое разбиение split_points и не проходят контейнер заново
+
+template <typename Iterator, typename Fn>
+void for_each(thread_pool& pool, const std::vector<Iterator>& bounds, Fn fn) {
+    pool.run(bounds.size() - 1, [&](size_t i) {
+        for (Iterator it = bounds[i]; it != bounds[i + 1]; ++it) fn(*it);
+    });
+}
+
+template <typename Container, typename Fn, typename = splittable<Container>>
+void for_each(thread_pool& pool, Container& container, Fn fn) {
+    for_each(pool, split(pool, container), fn);
+}
+
+// СВЕРТКА
+// init ⊕ transform(x0) ⊕ transform(x1) ⊕ ... с произвольной расстановкой скобок
+
+template <typename Iterator, typename T, typename Reduce, typename Transform>
+T transform_reduce(thread_pool& pool, const std::vector<Iterator>& bounds, T init, Reduce reduce, Transform transform) {
+    size_t parts = bounds.size() - 1;
+    std::vector<std::optional<T>> partial(parts);
+    pool.run(parts, [&](size_t i) {
+        Iterator it = bounds[i];
+        if (it == bounds[i + 1]) return;
+        T value = transform(*it);
+        for (++it; it != bounds[i + 1]; ++it) value = reduce(std::move(value), transform(*it));
+        partial[i] = std::move(value);
+    });
+    for (std::optional<T>& value : partial) {
+        if (value) init = reduce(std::move(init), std::move(*value));
+    }
+    return init;
+}
+
+template <typename Container, typename T, typename Reduce, typename Transform, typename = splittable<Container>>
+T transform_reduce(thread_pool& pool, Container& container, T init, Reduce reduce, Transform transform) {
+    return transform_reduce(pool, split(pool, container), std::move(init), reduce, transform);
+}
+
+// ПОИСК
+// Первый по порядку элемент с pred(x), иначе конец последнего диапазона.
+// Диапазоны после уже найденного прекращают поиск.
+
+template <typename Iterator, typename Pred>
+Iterator find_if(thread_pool& pool, const std::vector<Iterator>& bounds, Pred pred) {
+    size_t parts = bounds.size() - 1;
+    std::vector<Iterator> found(parts, bounds.back());
+    std::atomic<size_t> first_hit(parts);
+    pool.run(parts, [&](size_t i) {
+        for (Iterator it = bounds[i]; it != bounds[i + 1]; ++it) {
+            if (first_hit.load(std::memory_order_relaxed) < i) return;
+            if (pred(*it)) {
+                found[i] = it;
+                size_t hit = first_hit.load(std::memory_order_relaxed);
+                while (i < hit && !first_hit.compare_exchange_weak(hit, i, std::memory_order_relaxed)) {}
+                return;
+            }
+        }
+    });
+    size_t hit = first_hit.load(std::memory_order_relaxed);
+    return hit < parts ? found[hit] : bounds.back();
+}
+
+template <typename Container, typename Pred, typename = splittable<Container>>
+typename Container::iterator find_if(thread_pool& pool, Container& container, Pred pred) {
+    return find_if(pool, split(pool, container), pred);
+}
+
+}  // namespace parallel
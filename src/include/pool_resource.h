@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+#include "common.h"
+
+// РЕСУРС ПАМЯТИ НА ПУЛЕ БЛОКОВ
+// Арена аллокатора под интерфейсом std::pmr::memory_resource: тип контейнера больше
+// не зависит от стратегии выделения, std::pmr::map/std::pmr::vector и MyContainer
+// с std::pmr::polymorphic_allocator работают поверх пула.
+// Запрос округляется до класса размера (кратного class_granularity), каждый класс —
+// отдельный подпул арены. Крупные и сверхвыровненные запросы уходят в upstream.
+template <size_t init_size = 10, typename Policy = default_allocator_policy>
+class pool_memory_resource : public std::pmr::memory_resource {
+private:
+    using arena_type = detail::arena<init_size, Policy>;
+    using pool_type = detail::slot_pool<init_size, Policy>;
+
+public:
+    // Шаг классов размера: malloc выравнивает блоки на max_align_t, ячейки кратного размера тоже
+    static constexpr size_t class_granularity = alignof(std::max_align_t);
+    // Самый крупный запрос, который обслуживает пул
+    static constexpr size_t max_pooled_bytes = 1024;
+    static constexpr size_t class_count = max_pooled_bytes / class_granularity;
+
+private:
+    arena_type arena;
+    std::pmr::memory_resource* upstream;
+    // Подпулы по номеру класса, создаются при первом запросе
+    pool_type* pools[class_count];
+
+    static size_t class_of(size_t bytes) { return bytes ? (bytes - 1) / class_granularity : 0; }
+    static bool pooled(size_t bytes, size_t alignment) {
+        return bytes <= max_pooled_bytes && alignment <= class_granularity;
+    }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+public:
+    explicit pool_memory_resource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+    pool_memory_resource(const pool_memory_resource&) = delete;
+    pool_memory_resource& operator=(const pool_memory_resource&) = delete;
+
+    // Возвращает системе пустые блоки всех классов сверх keep_empty на класс
+    size_t trim(size_t keep_empty = 0) noexcept { return arena.trim(keep_empty); }
+
+    allocator_stats get_stats() const { return arena.get_stats(); }
+
+    std::pmr::memory_resource* upstream_resource() const { return upstream; }
+    // Сколько классов размера уже обслуживается
+    size_t get_pool_count() const { return arena.get_pool_count(); }
+};
+
+template <size_t init_size, typename Policy>
+pool_memory_resource<init_size, Policy>::pool_memory_resource(std::pmr::memory_resource* upstream) :
+    upstream(upstream), pools()
+{
+}
+
+template <size_t init_size, typename Policy>
+void* pool_memory_resource<init_size, Policy>::do_allocate(size_t bytes, size_t alignment)
+{
+    if (!pooled(bytes, alignment)) return upstream->allocate(bytes, alignment);
+
+    size_t index = class_of(bytes);
+    if (!pools[index]) {
+        pools[index] = &arena.pool_for((index + 1) * class_granularity, class_granularity);
+    }
+    return pools[index]->allocate(1);
+}
+
+template <size_t init_size, typename Policy>
+void pool_memory_resource<init_size, Policy>::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+    if (!pooled(bytes, alignment)) {
+        upstream->deallocate(p, bytes, alignment);
+        return;
+    }
+    if (pool_type* pool = pools[class_of(bytes)]) {
+        pool->deallocate(p, 1);
+    } else {
+        Policy::errors::report({allocation_error::foreign_pointer, p, 0, 0});
+    }
+}
+
+// Память одного пула нельзя освободить через другой
+template <size_t init_size, typename Policy>
+bool pool_memory_resource<init_size, Policy>::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
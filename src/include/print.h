@@ -0,0 +1,32 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+
+#include "common.h"
+
+// ВЫВОД СОДЕРЖИМОГО КОНТЕЙНЕРОВ
+// Отдельно от common.h, чтобы аллокатор и контейнер не тянули <iostream>
+namespace detail {
+    template<typename MapType>
+    void print_map(const MapType& map, const std::string& container_name = "") {
+        std::cout << (container_name.empty() ? "Map" : container_name) << std::endl;
+        std::cout << "Содержимое:" << std::endl;
+        
+        for (const auto& pair : map) {
+            std::cout << "  " << pair.first << " " << pair.second << std::endl;
+        }
+        
+        std::cout << "Размер: " << map.size() << " элементов" << std::endl << std::endl;
+    }
+    
+    template<typename ContainerType>
+    void print_container(const ContainerType& container, const std::string& container_name = "") {
+        std::cout << (container_name.empty() ? "Container" : container_name) << std::endl;
+        std::cout << "Содержимое: ";
+        
+        container.print(std::cout);
+        
+        std::cout << "Размер: " << container.size() << " элементов" << std::endl << std::endl;
+    }
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "allocation_trace.h"
+#include "common.h"
+
+// ПРОИГРЫВАНИЕ ТРАССЫ
+// Трасса один раз готовится к проигрыванию: адреса заменяются номерами выделений,
+// размеры ячеек — номерами подпулов. Затем ее можно прогнать через арену любой
+// конфигурации. Записи всех потоков проигрываются в одном потоке в порядке времени.
+
+struct replay_result {
+    size_t operations = 0;
+    double seconds = 0;
+    double ops_per_second = 0;
+    size_t peak_live_bytes = 0;    // пик занятых ячеек
+    size_t peak_block_bytes = 0;   // пик памяти, взятой у поставщика под блоки
+    size_t peak_blocks = 0;
+    size_t new_blocks = 0;
+    size_t final_blocks = 0;       // блоков в арене после проигрывания
+};
+
+namespace detail {
+
+// Поставщик, который считает текущий и пиковый объем выданных блоков
+template <typename Provider>
+struct metered_provider {
+    static constexpr size_t alignment = Provider::alignment;
+
+    struct meter {
+        std::atomic<size_t> bytes{0};
+        std::atomic<size_t> peak_bytes{0};
+        std::atomic<size_t> blocks{0};
+        std::atomic<size_t> peak_blocks{0};
+    };
+
+    static meter& get() noexcept {
+        static meter m;
+        return m;
+    }
+
+    static void reset() noexcept {
+        meter& m = get();
+        m.peak_bytes.store(m.bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        m.peak_blocks.store(m.blocks.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    static void* allocate(size_t bytes) noexcept {
+        void* p = Provider::allocate(bytes);
+        if (!p) return p;
+        meter& m = get();
+        raise(m.peak_bytes, m.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+        raise(m.peak_blocks, m.blocks.fetch_add(1, std::memory_order_relaxed) + 1);
+        return p;
+    }
+
+    static void deallocate(void* p, size_t bytes) noexcept {
+        Provider::deallocate(p, bytes);
+        meter& m = get();
+        m.bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        m.blocks.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+private:
+    static void raise(std::atomic<size_t>& peak, size_t value) noexcept {
+        size_t seen = peak.load(std::memory_order_relaxed);
+        while (seen < value && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+    }
+};
+
+// Политика проигрывания: та же конфигурация, но со счетчиками и учетом блоков, без записи трассы
+template <typename Policy>
+struct replay_policy : Policy {
+    using provider = metered_provider<typename Policy::provider>;
+    static constexpr bool collect_stats = true;
+    static constexpr bool record_trace = false;
+};
+
+}  // namespace detail
+
+class prepared_trace {
+public:
+    struct op {
+        std::uint32_t id;      // номер выделения
+        std::uint32_t count;
+        std::uint32_t pool;    // номер в slot_classes
+        bool allocate;
+    };
+
+    // Освобождения неизвестных адресов (выделенных до start() или потерянных
+    // при переполнении кольца) пропускаются и считаются в skipped
+    explicit prepared_trace(const std::vector<trace_record>& records) : allocations(0), skipped(0) {
+        std::unordered_map<std::uint64_t, std::uint32_t> live;
+        ops.reserve(records.size());
+        for (const trace_record& record : records) {
+            std::pair<size_t, size_t> slot_class(record.slot_size, size_t(1) << record.slot_align_log2);
+            std::uint32_t pool = 0;
+            while (pool < slot_classes.size() && slot_classes[pool] != slot_class) ++pool;
+            if (pool == slot_classes.size()) slot_classes.push_back(slot_class);
+
+            if (record.op == trace_op::allocate) {
+                live[record.slot] = allocations;
+                ops.push_back({allocations++, record.count, pool, true});
+                continue;
+            }
+            auto it = live.find(record.slot);
+            if (it == live.end()) {
+                ++skipped;
+                continue;
+            }
+            ops.push_back({it->second, record.count, pool, false});
+            live.erase(it);
+        }
+    }
+
+    std::vector<op> ops;
+    // Пары (размер ячейки, выравнивание)
+    std::vector<std::pair<size_t, size_t>> slot_classes;
+    std::uint32_t allocations;
+    size_t skipped;
+};
+
+// Прогоняет трассу через свежую арену allocator<_, init_size, Policy>
+template <size_t init_size, typename Policy = default_allocator_policy>
+replay_result replay_trace(const prepared_trace& trace) {
+    using policy = detail::replay_policy<Policy>;
+    using pool_type = detail::slot_pool<init_size, policy>;
+
+    detail::arena<init_size, policy> arena;
+    std::vector<pool_type*> pools;
+    for (const auto& slot_class : trace.slot_classes) {
+        pools.push_back(&arena.pool_for(slot_class.first, slot_class.second));
+    }
+    std::vector<void*> pointers(trace.allocations);
+    // Счетчик общий для поставщика: блоки других арен вычитаются
+    auto& meter = policy::provider::get();
+    policy::provider::reset();
+    size_t base_bytes = meter.bytes.load(std::memory_order_relaxed);
+    size_t base_blocks = meter.blocks.load(std::memory_order_relaxed);
+
+    auto start = std::chrono::steady_clock::now();
+    for (const prepared_trace::op& op : trace.ops) {
+        if (op.allocate) {
+            pointers[op.id] = pools[op.pool]->allocate(op.count);
+        } else {
+            pools[op.pool]->deallocate(pointers[op.id], op.count);
+        }
+    }
+    auto stop = std::chrono::steady_clock::now();
+
+    replay_result result;
+    allocator_stats stats = arena.get_stats();
+    result.operations = trace.ops.size();
+    result.seconds = std::chrono::duration<double>(stop - start).count();
+    result.ops_per_second = result.seconds > 0 ? result.operations / result.seconds : 0;
+    result.peak_live_bytes = stats.peak_live_bytes;
+    result.peak_block_bytes = meter.peak_bytes.load(std::memory_order_relaxed) - base_bytes;
+    result.peak_blocks = meter.peak_blocks.load(std::memory_order_relaxed) - base_blocks;
+    result.new_blocks = stats.new_blocks;
+    result.final_blocks = stats.block_count;
+    return result;
+}
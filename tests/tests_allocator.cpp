@@ -3,8 +3,94 @@
 #define BOOST_TEST_MODULE AllocatorTests
 
 #include "common.h"
+#include "concurrent_allocator.h"
+#include "flat_map.h"
+#include "lockfree_pool.h"
+#include "parallel.h"
+#include "pool_resource.h"
+#include "trace_replay.h"
 #include <boost/test/unit_test.hpp>
 
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <numeric>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+// ============================================
+// СЧЕТЧИК ОБРАЩЕНИЙ К КУЧЕ
+// ============================================
+
+// Глобальный operator new считает вызовы и по требованию отказывает:
+// тесты проверяют число выделений и поведение при нехватке памяти
+namespace heap_probe {
+    std::atomic<size_t> news{0};
+    std::atomic<bool> fail_aligned{false};
+}
+
+void* operator new(size_t size) {
+    heap_probe::news.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t align) {
+    heap_probe::news.fetch_add(1, std::memory_order_relaxed);
+    if (heap_probe::fail_aligned.load(std::memory_order_relaxed)) throw std::bad_alloc();
+    size_t alignment = static_cast<size_t>(align);
+    if (void* p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)) return p;
+    throw std::bad_alloc();
+}
+
+// Остальные формы заменены тоже: иначе их перехватывает санитайзер, и память его new
+// попадала бы в free ниже
+void* operator new[](size_t size) { return ::operator new(size); }
+void* operator new[](size_t size, std::align_val_t align) { return ::operator new(size, align); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try { return ::operator new(size); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try { return ::operator new(size); } catch (...) { return nullptr; }
+}
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    try { return ::operator new(size, align); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    try { return ::operator new(size, align); } catch (...) { return nullptr; }
+}
+
+// Память замененного operator new пришла из malloc: free здесь парная операция,
+// а GCC после встраивания принимает ее за несовпадение с new
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
 // ============================================
 // БАЗОВЫЕ ТЕСТЫ АЛЛОКАТОРА
 // ============================================
@@ -39,10 +125,18 @@ BOOST_AUTO_TEST_CASE(AllocateAndConstruct) {
 BOOST_AUTO_TEST_CASE(AllocatorLimits) {
     std::cout << "Тест: Проверка лимитов аллокатора" << std::endl;
     
-    // Тест 1: Запрос больше размера блока вызывает исключение
+    // Тест 1: Запрос больше размера блока получает отдельный блок
     {
         allocator<int, 5> alloc;
-        BOOST_CHECK_THROW(alloc.allocate(6), std::bad_alloc);
+        int* p = alloc.allocate(6);
+        BOOST_CHECK(p != nullptr);
+        BOOST_CHECK_EQUAL(alloc.get_used(), 6);
+        BOOST_CHECK_EQUAL(alloc.get_block_count(), 1);
+        
+        // После освобождения отдельный блок сразу удаляется
+        alloc.deallocate(p, 6);
+        BOOST_CHECK_EQUAL(alloc.get_used(), 0);
+        BOOST_CHECK_EQUAL(alloc.get_block_count(), 0);
     }
     
     // Тест 2: Заполнение блока до предела работает
@@ -74,6 +168,664 @@ BOOST_AUTO_TEST_CASE(TestDeallocateReuse) {
     BOOST_CHECK_EQUAL(alloc.get_used(), 3);  // Снова 3
 }
 
+BOOST_AUTO_TEST_CASE(TestBitmapRunAcrossWords) {
+    std::cout << "Тест: Поиск свободной серии через границу слов битовой карты" << std::endl;
+    
+    allocator<int, 200> alloc;
+    
+    int* p1 = alloc.allocate(60);
+    int* p2 = alloc.allocate(10);  // ячейки 60..69 пересекают границу 64
+    BOOST_CHECK_EQUAL(p2, p1 + 60);
+    BOOST_CHECK_EQUAL(alloc.get_used(), 70);
+    
+    // Серия из 100 ячеек начинается сразу после занятых
+    int* p3 = alloc.allocate(100);
+    BOOST_CHECK_EQUAL(p3, p1 + 70);
+    
+    // Освобожденная дыра переиспользуется, если в нее помещается запрос
+    alloc.deallocate(p2, 10);
+    BOOST_CHECK_EQUAL(alloc.allocate(8), p2);
+    BOOST_CHECK_EQUAL(alloc.allocate(2), p2 + 8);
+    BOOST_CHECK_EQUAL(alloc.get_used(), 170);
+    
+    // Повторное освобождение не уменьшает счетчик второй раз
+    alloc.deallocate(p1, 60);
+    alloc.deallocate(p1, 1);
+    BOOST_CHECK_EQUAL(alloc.get_used(), 110);
+}
+
+BOOST_AUTO_TEST_CASE(TestSingleSlotFreeList) {
+    std::cout << "Тест: Список освобожденных ячеек для allocate(1)" << std::endl;
+    
+    allocator<long long, 4> alloc;
+    
+    long long* p1 = alloc.allocate(1);
+    long long* p2 = alloc.allocate(1);
+    long long* p3 = alloc.allocate(1);
+    
+    // Освобожденные ячейки возвращаются в порядке LIFO
+    alloc.deallocate(p2, 1);
+    alloc.deallocate(p3, 1);
+    BOOST_CHECK_EQUAL(alloc.get_used(), 1);
+    BOOST_CHECK_EQUAL(alloc.allocate(1), p3);
+    BOOST_CHECK_EQUAL(alloc.allocate(1), p2);
+    
+    // Повторное освобождение ячейки из списка обнаруживается
+    alloc.deallocate(p3, 1);
+    alloc.deallocate(p3, 1);
+    BOOST_CHECK_EQUAL(alloc.get_used(), 2);
+    
+    // Серия из нескольких ячеек собирается из закэшированных в том же блоке
+    alloc.deallocate(p1, 1);
+    alloc.deallocate(p2, 1);
+    BOOST_CHECK_EQUAL(alloc.allocate(4), p1);
+    BOOST_CHECK_EQUAL(alloc.get_used(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(TestBlockDirectory) {
+    std::cout << "Тест: Каталог блоков и освобождение в произвольном порядке" << std::endl;
+    
+    allocator<long long, 2> alloc;
+    std::vector<long long*> ptrs;
+    for (int i = 0; i < 1000; ++i) {
+        ptrs.push_back(alloc.allocate(1));
+    }
+    BOOST_CHECK_EQUAL(alloc.get_block_count(), 500);
+    BOOST_CHECK_EQUAL(alloc.get_used(), 1000);
+    
+    // Освобождаем через один, начиная с последних блоков
+    for (size_t i = ptrs.size(); i-- > 0;) {
+        if (i % 2) alloc.deallocate(ptrs[i], 1);
+    }
+    BOOST_CHECK_EQUAL(alloc.get_used(), 500);
+    
+    // Освободившиеся ячейки переиспользуются без новых блоков
+    for (int i = 0; i < 500; ++i) {
+        BOOST_CHECK(alloc.allocate(1) != nullptr);
+    }
+    BOOST_CHECK_EQUAL(alloc.get_block_count(), 500);
+    BOOST_CHECK_EQUAL(alloc.get_used(), 1000);
+    
+    // Серия из двух ячеек требует нового блока
+    alloc.allocate(2);
+    BOOST_CHECK_EQUAL(alloc.get_block_count(), 501);
+}
+
+struct doubling_policy : default_allocator_policy {
+    using growth = doubling_growth;
+};
+
+struct capped_policy : default_allocator_policy {
+    using growth = capped_growth<8>;
+};
+
+BOOST_AUTO_TEST_CASE(TestBlockGrowthPolicy) {
+    std::cout << "Тест: Политики роста блоков" << std::endl;
+    
+    // Удвоение: блоки по 4, 8, 16 ячеек
+    {
+        allocator<long long, 4, doubling_policy> alloc;
+        for (int i = 0; i < 28; ++i) alloc.allocate(1);
+        BOOST_CHECK_EQUAL(alloc.get_block_count(), 3);
+        BOOST_CHECK_EQUAL(alloc.get_capacity(), 28);
+    }
+    
+    // Удвоение с ограничением: 4, 8, 8, 8
+    {
+        allocator<long long, 4, capped_policy> alloc;
+        for (int i = 0; i < 28; ++i) alloc.allocate(1);
+        BOOST_CHECK_EQUAL(alloc.get_block_count(), 4);
+        BOOST_CHECK_EQUAL(alloc.get_capacity(), 28);
+    }
+    
+    // Запрос больше ограничения обслуживается отдельным блоком
+    {
+        allocator<long long, 4, capped_policy> alloc;
+        long long* p = alloc.allocate(20);
+        BOOST_CHECK(p != nullptr);
+        BOOST_CHECK_EQUAL(alloc.get_capacity(), 20);
+        alloc.deallocate(p, 20);
+        BOOST_CHECK_EQUAL(alloc.get_capacity(), 0);
+    }
+}
+
+struct no_retention_policy : default_allocator_policy {
+    using retention = release_empty_blocks;
+};
+
+struct keep_all_policy : default_allocator_policy {
+    using retention = keep_all_blocks;
+};
+
+BOOST_AUTO_TEST_CASE(TestEmptyBlockRetention) {
+    std::cout << "Тест: Удержание и возврат пустых блоков" << std::endl;
+    
+    // По умолчанию удерживается один запасной блок и текущий
+    {
+        allocator<long long, 4> alloc;
+        std::vector<long long*> ptrs;
+        for (int i = 0; i < 16; ++i) ptrs.push_back(alloc.allocate(1));
+        BOOST_CHECK_EQUAL(alloc.get_block_count(), 4);
+        
+        for (long long* p : ptrs) alloc.deallocate(p, 1);
+        BOOST_CHECK_EQUAL(alloc.get_used(), 0);
+        BOOST_CHECK_EQUAL(alloc.get_block_count(), 2);
+        
+        // trim отдает системе все пустые блоки
+        BOOST_CHECK_EQUAL(alloc.trim(), 2);
+        BOOST_CHECK_EQUAL(alloc.get_block_count(), 0);
+        BOOST_CHECK(alloc.allocate(1) != nullptr);
+        BOOST_CHECK_EQUAL(alloc.get_block_count(), 1);
+    }
+    
+    // Без удержания остается только текущий блок
+    {
+        allocator<long long, 4, no_retention_policy> alloc;
+        std::vector<long long*> ptrs;
+        for (int i = 0; i < 16; ++i) ptrs.push_back(alloc.allocate(1));
+        for (long long* p : ptrs) alloc.deallocate(p, 1);
+        BOOST_CHECK_EQUAL(alloc.get_block_count(), 1);
+    }
+    
+    // trim с запасом оставляет нужное число пустых блоков
+    {
+        allocator<long long, 4, keep_all_policy> alloc;
+        std::vector<long long*> ptrs;
+        for (int i = 0; i < 16; ++i) ptrs.push_back(alloc.allocate(1));
+        for (long long* p : ptrs) alloc.deallocate(p, 1);
+        BOOST_CHECK_EQUAL(alloc.get_block_count(), 4);
+        BOOST_CHECK_EQUAL(alloc.trim(1), 3);
+        BOOST_CHECK_EQUAL(alloc.get_block_count(), 1);
+    }
+}
+
+// Поставщик со своим счетчиком: блоки этого теста не смешиваются с блоками других
+struct teardown_provider : malloc_provider {};
+
+struct teardown_policy : default_allocator_policy {
+    using provider = detail::metered_provider<teardown_provider>;
+};
+
+BOOST_AUTO_TEST_CASE(TestTeardownReleasesAllBlocks) {
+    std::cout << "Тест: Разрушение аллокатора освобождает все блоки" << std::endl;
+    
+    auto& meter = detail::metered_provider<teardown_provider>::get();
+    {
+        allocator<long long, 4, teardown_policy> alloc;
+        for (int i = 0; i < 100; ++i) alloc.allocate(1);
+        alloc.allocate(3);
+        alloc.allocate(50);  // отдельный блок
+        
+        std::map<int, int, std::less<int>, allocator<std::pair<const int, int>, 4, teardown_policy>> map;
+        for (int i = 0; i < 100; ++i) map[i] = i;
+        
+        std::vector<int, allocator<int, 4, teardown_policy>> vec(1000, 1);
+        BOOST_CHECK(alloc.get_block_count() > 25);
+        BOOST_CHECK(meter.blocks.load() > alloc.get_block_count());
+    }
+    // Каждый взятый у поставщика блок возвращен
+    BOOST_CHECK_EQUAL(meter.blocks.load(), 0);
+    BOOST_CHECK_EQUAL(meter.bytes.load(), 0);
+    BOOST_CHECK(meter.peak_blocks.load() > 25);
+}
+
+template <typename Provider>
+struct provider_policy : default_allocator_policy {
+    using provider = Provider;
+};
+
+template <typename Provider>
+void check_map_on_provider() {
+    using MapAlloc = allocator<std::pair<const int, int>, 1024, provider_policy<Provider>>;
+    std::map<int, int, std::less<int>, MapAlloc> map;
+    for (int i = 0; i < 5000; ++i) {
+        map[i] = i * 2;
+    }
+    long long sum = 0;
+    for (const auto& kv : map) sum += kv.second;
+    BOOST_CHECK_EQUAL(map.size(), 5000);
+    BOOST_CHECK_EQUAL(sum, 4999LL * 5000);
+}
+
+BOOST_AUTO_TEST_CASE(TestBlockProviders) {
+    std::cout << "Тест: Поставщики памяти для блоков" << std::endl;
+    
+    check_map_on_provider<malloc_provider>();
+    check_map_on_provider<mmap_provider>();
+    check_map_on_provider<huge_page_provider>();
+    check_map_on_provider<numa_local_provider>();
+    
+    // Блок из mmap начинается на границе страницы
+    allocator<long long, 512, provider_policy<mmap_provider>> alloc;
+    long long* p = alloc.allocate(1);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(p) % 4096, 0);
+}
+
+// Сверхвыровненные типы
+struct alignas(64) wide_value {
+    double lanes[3];
+};
+
+struct alignas(256) page_value {
+    int value;
+};
+
+// Каждая ячейка на своей кэш-линии
+struct padded_policy : default_allocator_policy {
+    using layout = cache_line_layout;
+};
+
+BOOST_AUTO_TEST_CASE(TestOverAlignedSlots) {
+    std::cout << "Тест: Выравнивание ячеек и раскладка по кэш-линиям" << std::endl;
+    
+    allocator<wide_value, 5> alloc;
+    std::vector<wide_value*> values;
+    for (int i = 0; i < 12; ++i) {
+        values.push_back(alloc.allocate(1));
+        BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(values.back()) % alignof(wide_value), 0);
+    }
+    wide_value* array = alloc.allocate(3);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(array) % alignof(wide_value), 0);
+    alloc.deallocate(array, 3);
+    for (wide_value* v : values) alloc.deallocate(v, 1);
+    
+    // Выравнивание больше страницы поставщика mmap
+    allocator<page_value, 4, provider_policy<mmap_provider>> page_alloc;
+    page_value* p = page_alloc.allocate(1);
+    page_value* q = page_alloc.allocate(1);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(p) % 256, 0);
+    BOOST_CHECK_EQUAL(reinterpret_cast<char*>(q) - reinterpret_cast<char*>(p), 256);
+    page_alloc.deallocate(q, 1);
+    page_alloc.deallocate(p, 1);
+    
+    std::vector<wide_value, allocator<wide_value, 8>> vec(20);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(vec.data()) % alignof(wide_value), 0);
+    
+    // Соседние объекты не делят кэш-линию
+    allocator<int, 8, padded_policy> padded;
+    int* a = padded.allocate(1);
+    int* b = padded.allocate(1);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(a) % 64, 0);
+    BOOST_CHECK_EQUAL(reinterpret_cast<char*>(b) - reinterpret_cast<char*>(a), 64);
+    // Элементы массива лежат вплотную: 4 int помещаются в одну ячейку
+    int* c = padded.allocate(4);
+    c[3] = 7;
+    BOOST_CHECK_EQUAL(padded.get_used(), 3);
+    padded.deallocate(c, 4);
+    BOOST_CHECK_EQUAL(padded.get_used(), 2);
+    // 1000 int — 4000 байт, то есть 63 кэш-линии, а не 1000
+    int* big = padded.allocate(1000);
+    big[999] = 1;
+    BOOST_CHECK_EQUAL(padded.get_used(), 2 + 63);
+    padded.deallocate(big, 1000);
+    padded.deallocate(b, 1);
+    padded.deallocate(a, 1);
+    BOOST_CHECK_EQUAL(padded.get_used(), 0);
+    std::vector<int, allocator<int, 8, padded_policy>> padded_vec(1000, 1);
+    BOOST_CHECK_EQUAL(std::accumulate(padded_vec.begin(), padded_vec.end(), 0), 1000);
+}
+
+struct callback_policy : default_allocator_policy {
+    using errors = callback_errors;
+};
+
+std::vector<allocation_error_info> reported_errors;
+
+void remember_error(const allocation_error_info& info) noexcept {
+    reported_errors.push_back(info);
+}
+
+BOOST_AUTO_TEST_CASE(TestErrorPolicies) {
+    std::cout << "Тест: Политики обработки ошибок" << std::endl;
+    
+    // По умолчанию ошибки подсчитываются
+    {
+        count_errors::reset();
+        allocator<long long, 8> alloc;
+        long long* p = alloc.allocate(2);
+        alloc.deallocate(p, 2);
+        alloc.deallocate(p, 2);
+        long long foreign = 0;
+        alloc.deallocate(&foreign, 1);
+        BOOST_CHECK_EQUAL(count_errors::count(allocation_error::double_free), 2);
+        BOOST_CHECK_EQUAL(count_errors::count(allocation_error::foreign_pointer), 1);
+        BOOST_CHECK_EQUAL(alloc.get_used(), 0);
+    }
+    
+    // Пользовательский обработчик получает адрес и номер ячейки
+    {
+        callback_errors::set_handler(&remember_error);
+        allocator<long long, 8, callback_policy> alloc;
+        long long* p = alloc.allocate(3);
+        alloc.deallocate(p + 1, 1);
+        alloc.deallocate(p + 1, 1);
+        BOOST_REQUIRE_EQUAL(reported_errors.size(), 1);
+        BOOST_CHECK(reported_errors[0].kind == allocation_error::double_free);
+        BOOST_CHECK_EQUAL(reported_errors[0].address, p + 1);
+        BOOST_CHECK_EQUAL(reported_errors[0].slot, 1);
+        callback_errors::set_handler(nullptr);
+    }
+}
+
+// Политика со сбором счетчиков статистики
+struct stats_policy : default_allocator_policy {
+    using errors = silent_errors;
+    static constexpr bool collect_stats = true;
+};
+
+BOOST_AUTO_TEST_CASE(TestAllocatorStats) {
+    std::cout << "Тест: Статистика аллокатора" << std::endl;
+    
+    allocator<long long, 10, stats_policy> alloc;
+    std::vector<long long*> pointers;
+    for (int i = 0; i < 15; ++i) {
+        pointers.push_back(alloc.allocate(1));
+    }
+    allocator<char, 10, stats_policy> bytes(alloc);
+    char* text = bytes.allocate(4);
+    
+    alloc.deallocate(pointers[2], 1);
+    alloc.deallocate(pointers[3], 1);
+    alloc.deallocate(pointers[3], 1);  // Повторное освобождение
+    
+    allocator_stats stats = alloc.get_stats();
+    BOOST_CHECK(stats.counters_enabled);
+    BOOST_CHECK_EQUAL(stats.init_size, 10);
+    BOOST_CHECK_EQUAL(stats.pool_count, 2);
+    BOOST_CHECK_EQUAL(stats.block_count, 3);
+    BOOST_CHECK_EQUAL(stats.live_bytes, 13 * sizeof(long long) + 4);
+    BOOST_CHECK_EQUAL(stats.peak_live_bytes, 15 * sizeof(long long) + 4);
+    BOOST_CHECK_EQUAL(stats.capacity_bytes, 20 * sizeof(long long) + 10);
+    BOOST_CHECK_EQUAL(stats.allocations, 16);
+    BOOST_CHECK_EQUAL(stats.deallocations, 3);
+    BOOST_CHECK_EQUAL(stats.new_blocks, 3);
+    BOOST_CHECK_EQUAL(stats.double_frees, 1);
+    // Первый блок: 8 из 10, второй: 5 из 10, блок char: 4 из 10
+    BOOST_CHECK_EQUAL(stats.fill_histogram[8], 1);
+    BOOST_CHECK_EQUAL(stats.fill_histogram[5], 1);
+    BOOST_CHECK_EQUAL(stats.fill_histogram[4], 1);
+    // Самый длинный свободный участок — хвост второго блока
+    BOOST_CHECK_EQUAL(stats.largest_free_run_bytes, 5 * sizeof(long long));
+    BOOST_CHECK(stats.fragmentation > 0 && stats.fragmentation < 1);
+    
+    std::string json = to_json(stats);
+    BOOST_CHECK(json.front() == '{' && json.back() == '}');
+    BOOST_CHECK(json.find("\"double_frees\":1") != std::string::npos);
+    BOOST_CHECK(json.find("\"fill_histogram\":[0,0,0,0,1,1,0,0,1,0,0]") != std::string::npos);
+    
+    for (size_t i = 0; i < pointers.size(); ++i) {
+        if (i != 2 && i != 3) alloc.deallocate(pointers[i], 1);
+    }
+    bytes.deallocate(text, 4);
+    stats = alloc.get_stats();
+    BOOST_CHECK_EQUAL(stats.live_bytes, 0);
+    BOOST_CHECK_EQUAL(stats.empty_block_count, 3);
+    BOOST_CHECK_EQUAL(stats.fill_histogram[0], 3);
+    alloc.trim();
+    BOOST_CHECK_EQUAL(alloc.get_stats().released_blocks, 3);
+    
+    // Без сбора счетчиков структура доступна, счетчики нулевые
+    allocator<long long, 10> plain;
+    long long* p = plain.allocate(3);
+    allocator_stats plain_stats = plain.get_stats();
+    BOOST_CHECK(!plain_stats.counters_enabled);
+    BOOST_CHECK_EQUAL(plain_stats.live_bytes, 3 * sizeof(long long));
+    BOOST_CHECK_EQUAL(plain_stats.allocations, 0);
+    plain.deallocate(p, 3);
+}
+
+struct traced_policy : default_allocator_policy {
+    static constexpr bool record_trace = true;
+};
+
+BOOST_AUTO_TEST_CASE(TestAllocationTrace) {
+    std::cout << "Тест: Запись и проигрывание трассы выделений" << std::endl;
+    
+    allocator<long long, 4, traced_policy> alloc;
+    allocator<long long, 4> untraced;
+    long long* before = alloc.allocate(1);  // до start() не пишется
+    
+    allocation_trace::start();
+    long long* a = alloc.allocate(1);
+    long long* b = alloc.allocate(3);
+    long long* batch[2];
+    alloc.allocate_batch(batch, 2);
+    untraced.deallocate(untraced.allocate(1), 1);  // политика без трассы
+    alloc.deallocate(b, 3);
+    alloc.deallocate(before, 1);
+    std::thread([&] { alloc.deallocate(a, 1); }).join();
+    allocation_trace::stop();
+    alloc.deallocate(batch[0], 1);  // после stop() не пишется
+    
+    std::vector<trace_record> records = allocation_trace::drain();
+    BOOST_CHECK_EQUAL(allocation_trace::dropped(), 0);
+    BOOST_REQUIRE_EQUAL(records.size(), 7);
+    BOOST_CHECK(records[0].op == trace_op::allocate);
+    BOOST_CHECK_EQUAL(records[0].slot, reinterpret_cast<std::uintptr_t>(a));
+    BOOST_CHECK_EQUAL(records[1].count, 3);
+    BOOST_CHECK_EQUAL(records[1].slot_size, sizeof(long long));
+    BOOST_CHECK_EQUAL(size_t(1) << records[1].slot_align_log2, alignof(long long));
+    BOOST_CHECK(records[4].op == trace_op::deallocate);
+    BOOST_CHECK_EQUAL(records[4].slot, reinterpret_cast<std::uintptr_t>(b));
+    BOOST_CHECK(records[6].thread != records[0].thread);
+    for (size_t i = 1; i < records.size(); ++i) {
+        BOOST_CHECK(records[i - 1].timestamp_ns <= records[i].timestamp_ns);
+    }
+    BOOST_CHECK(allocation_trace::drain().empty());
+    
+    // Файл: запись и чтение без потерь, чужой файл не читается
+    const char* path = "allocation_trace_test.bin";
+    BOOST_REQUIRE(save_trace(path, records));
+    std::vector<trace_record> loaded;
+    BOOST_REQUIRE(load_trace(path, loaded));
+    BOOST_REQUIRE_EQUAL(loaded.size(), records.size());
+    BOOST_CHECK(std::memcmp(loaded.data(), records.data(), records.size() * sizeof(trace_record)) == 0);
+    std::FILE* file = std::fopen(path, "wb");
+    std::fputs("not a trace", file);
+    std::fclose(file);
+    BOOST_CHECK(!load_trace(path, loaded));
+    BOOST_CHECK(loaded.empty());
+    // Заголовок обещает больше записей, чем есть в файле: false, а не bad_alloc
+    for (std::uint64_t count : {std::uint64_t(1) << 60, std::uint64_t(records.size() + 1)}) {
+        BOOST_REQUIRE(save_trace(path, records));
+        file = std::fopen(path, "r+b");
+        std::fseek(file, offsetof(detail::trace_file_header, count), SEEK_SET);
+        std::fwrite(&count, sizeof(count), 1, file);
+        std::fclose(file);
+        BOOST_CHECK_NO_THROW(BOOST_CHECK(!load_trace(path, loaded)));
+        BOOST_CHECK(loaded.empty());
+    }
+    std::remove(path);
+    
+    // Освобождение ячейки, выделенной до start(), пропускается
+    prepared_trace trace(records);
+    BOOST_CHECK_EQUAL(trace.allocations, 4);
+    BOOST_CHECK_EQUAL(trace.skipped, 1);
+    BOOST_CHECK_EQUAL(trace.ops.size(), 6);
+    BOOST_CHECK_EQUAL(trace.slot_classes.size(), 1);
+    
+    replay_result small = replay_trace<4>(trace);
+    BOOST_CHECK_EQUAL(small.operations, 6);
+    BOOST_CHECK_EQUAL(small.peak_live_bytes, 6 * sizeof(long long));
+    BOOST_CHECK_EQUAL(small.new_blocks, 2);
+    BOOST_CHECK_EQUAL(small.peak_blocks, 2);
+    BOOST_CHECK(small.peak_block_bytes >= 8 * sizeof(long long));
+    replay_result large = replay_trace<64>(trace);
+    BOOST_CHECK_EQUAL(large.new_blocks, 1);
+    BOOST_CHECK(large.peak_block_bytes > small.peak_block_bytes);
+    
+    alloc.deallocate(batch[1], 1);
+}
+
+// Считает живые объекты, чтобы проверить вызов деструкторов
+struct counted {
+    static int alive;
+    int value;
+    counted(int v) : value(v) { ++alive; }
+    counted(const counted& other) : value(other.value) { ++alive; }
+    ~counted() { --alive; }
+};
+int counted::alive = 0;
+
+BOOST_AUTO_TEST_CASE(TestMonotonicMode) {
+    std::cout << "Тест: Монотонный режим и reset()" << std::endl;
+    
+    monotonic_allocator<int, 8> alloc;
+    int* a = alloc.allocate(1);
+    int* b = alloc.allocate(3);
+    int* c = alloc.allocate(1);
+    // Ячейки выдаются подряд
+    BOOST_CHECK_EQUAL(b, a + 1);
+    BOOST_CHECK_EQUAL(c, a + 4);
+    
+    // Освобождение ничего не делает
+    alloc.deallocate(b, 3);
+    BOOST_CHECK_EQUAL(alloc.get_used(), 5);
+    BOOST_CHECK_EQUAL(alloc.allocate(1), a + 5);
+    
+    // Переполнение блока заводит новый, reset оставляет один горячий блок
+    for (int i = 0; i < 12; ++i) alloc.allocate(1);
+    BOOST_CHECK_EQUAL(alloc.get_block_count(), 3);
+    BOOST_CHECK_EQUAL(alloc.reset(), 2);
+    BOOST_CHECK_EQUAL(alloc.get_block_count(), 1);
+    BOOST_CHECK_EQUAL(alloc.get_used(), 0);
+    int* again = alloc.allocate(1);
+    BOOST_CHECK_EQUAL(alloc.get_used(), 1);
+    BOOST_CHECK(alloc.get_data() == again);
+    
+    // std::map целиком на монотонной арене
+    {
+        std::map<int, int, std::less<int>, monotonic_allocator<std::pair<const int, int>, 16>> map;
+        for (int i = 0; i < 50; ++i) map[i] = i;
+        for (int i = 0; i < 50; i += 2) map.erase(i);
+        BOOST_CHECK_EQUAL(map.size(), 25);
+        BOOST_CHECK_EQUAL(map[7], 7);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(TestMyContainerBulkClear) {
+    std::cout << "Тест: Быстрый clear() MyContainer на монотонной арене" << std::endl;
+    
+    using Alloc = monotonic_allocator<counted, 8>;
+    Alloc alloc;
+    {
+        MyContainer<counted, Alloc> container(alloc);
+        for (int i = 0; i < 20; ++i) container.add(counted(i));
+        BOOST_CHECK_EQUAL(counted::alive, 20);
+        
+        size_t live_before = alloc.get_stats().live_bytes;
+        container.clear();
+        // Деструкторы вызваны, узлы не освобождались поштучно
+        BOOST_CHECK_EQUAL(counted::alive, 0);
+        BOOST_CHECK(container.empty());
+        BOOST_CHECK_EQUAL(alloc.get_stats().live_bytes, live_before);
+        
+        container.add(counted(42));
+        BOOST_CHECK_EQUAL(container.begin()->value, 42);
+    }
+    BOOST_CHECK_EQUAL(counted::alive, 0);
+    alloc.reset();
+    BOOST_CHECK_EQUAL(alloc.get_stats().live_bytes, 0);
+}
+
+template <typename Base>
+struct metered_inline_policy : Base {
+    using provider = detail::metered_provider<malloc_provider>;
+    static constexpr size_t inline_bytes = 512;
+};
+
+BOOST_AUTO_TEST_CASE(TestInlineFirstBlock) {
+    std::cout << "Тест: Первый блок в памяти арены" << std::endl;
+    
+    using Policy = metered_inline_policy<default_allocator_policy>;
+    auto& meter = detail::metered_provider<malloc_provider>::get();
+    size_t base_blocks = meter.blocks.load();
+    {
+        allocator<int, 64, Policy> alloc;
+        int* first = alloc.allocate(1);
+        int* run = alloc.allocate(5);
+        // Поставщик не тронут, ячейки лежат в арене
+        BOOST_CHECK_EQUAL(meter.blocks.load(), base_blocks);
+        BOOST_CHECK_EQUAL(alloc.get_block_count(), 1);
+        size_t inline_capacity = alloc.get_capacity();
+        BOOST_CHECK(inline_capacity > 64 && inline_capacity < 128);
+        BOOST_CHECK_EQUAL(run, first + 1);
+        
+        // Переполнение уходит к поставщику обычным блоком init_size
+        std::vector<int*> rest;
+        for (size_t i = 6; i < inline_capacity + 1; ++i) rest.push_back(alloc.allocate(1));
+        BOOST_CHECK_EQUAL(meter.blocks.load(), base_blocks + 1);
+        BOOST_CHECK_EQUAL(alloc.get_capacity(), inline_capacity + 64);
+        
+        // Освобожденная память арены снова используется
+        alloc.deallocate(first, 1);
+        alloc.deallocate(run, 5);
+        for (int* p : rest) alloc.deallocate(p, 1);
+        BOOST_CHECK_EQUAL(alloc.trim(), 2);
+        BOOST_CHECK_EQUAL(meter.blocks.load(), base_blocks);
+        int* again = alloc.allocate(1);
+        BOOST_CHECK_EQUAL(again, first);
+        BOOST_CHECK_EQUAL(meter.blocks.load(), base_blocks);
+        
+        // Запрос больше памяти арены сразу идет к поставщику
+        alloc.deallocate(again, 1);
+        int* large = alloc.allocate(inline_capacity + 1);
+        BOOST_CHECK_EQUAL(meter.blocks.load(), base_blocks + 1);
+        alloc.deallocate(large, inline_capacity + 1);
+    }
+    BOOST_CHECK_EQUAL(meter.blocks.load(), base_blocks);
+    
+    // Маленькие map и MyContainer живут целиком в арене, выравнивание соблюдается
+    {
+        std::map<int, int, std::less<int>, allocator<std::pair<const int, int>, 64, Policy>> map;
+        for (int i = 0; i < 5; ++i) map[i] = i;
+        MyContainer<int, allocator<int, 64, Policy>> container = {1, 2, 3};
+        allocator<wide_value, 4, Policy> wide;
+        wide_value* w = wide.allocate(2);
+        BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(w) % alignof(wide_value), 0);
+        BOOST_CHECK_EQUAL(meter.blocks.load(), base_blocks);
+        BOOST_CHECK_EQUAL(map[4], 4);
+        BOOST_CHECK_EQUAL(*container.begin(), 1);
+        wide.deallocate(w, 2);
+    }
+    
+    // Монотонный режим: без битовых карт в арену помещается больше ячеек
+    allocator<int, 64, metered_inline_policy<monotonic_allocator_policy>> bump;
+    int* a = bump.allocate(1);
+    BOOST_CHECK_EQUAL(bump.allocate(1), a + 1);
+    BOOST_CHECK(bump.get_capacity() >= 100);
+    BOOST_CHECK_EQUAL(meter.blocks.load(), base_blocks);
+    bump.reset();
+    BOOST_CHECK_EQUAL(bump.allocate(1), a);
+}
+
+BOOST_AUTO_TEST_CASE(TestInlineArenaSingleAllocation) {
+    std::cout << "Тест: Контейнер в памяти арены обходится одной аллокацией" << std::endl;
+    
+    // Подпул, каталог блоков и первый блок лежат в арене: кучу трогает только сама арена
+    using Policy = inline_allocator_policy<512>;
+    size_t before = heap_probe::news.load();
+    size_t container_news = 0;
+    {
+        MyContainer<int, allocator<int, 16, Policy>> container;
+        for (int i = 0; i < 3; ++i) container.add(i);
+        container_news = heap_probe::news.load() - before;
+        BOOST_CHECK_EQUAL(container.size(), 3);
+    }
+    BOOST_CHECK_EQUAL(container_news, 1);
+    
+    before = heap_probe::news.load();
+    size_t map_news = 0;
+    {
+        std::map<int, int, std::less<int>, allocator<std::pair<const int, int>, 16, Policy>> map;
+        map[1] = 1;
+        map[2] = 2;
+        map_news = heap_probe::news.load() - before;
+        BOOST_CHECK_EQUAL(map.size(), 2);
+    }
+    BOOST_CHECK_EQUAL(map_news, 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 // ============================================
@@ -104,15 +856,192 @@ BOOST_AUTO_TEST_CASE(StdVectorWithAllocator) {
     
     std::vector<int, allocator<int, 10>> vec;
     
-    // Добавляем элементы
-    for (int i = 0; i < 5; ++i) {
+    // Добавляем элементы, в том числе больше размера блока
+    for (int i = 0; i < 100; ++i) {
         vec.push_back(i * 10);
     }
     
-    BOOST_CHECK_EQUAL(vec.size(), 5);
+    BOOST_CHECK_EQUAL(vec.size(), 100);
     BOOST_CHECK_EQUAL(vec[0], 0);
     BOOST_CHECK_EQUAL(vec[2], 20);
     BOOST_CHECK_EQUAL(vec[4], 40);
+    BOOST_CHECK_EQUAL(vec[99], 990);
+}
+
+BOOST_AUTO_TEST_CASE(StdStringWithAllocator) {
+    std::cout << "Тест: std::basic_string с аллокатором" << std::endl;
+    
+    using PoolString = std::basic_string<char, std::char_traits<char>, allocator<char, 16>>;
+    PoolString str;
+    for (int i = 0; i < 10; ++i) {
+        str += "0123456789";
+    }
+    
+    BOOST_CHECK_EQUAL(str.size(), 100);
+    BOOST_CHECK_EQUAL(str[55], '5');
+}
+
+BOOST_AUTO_TEST_CASE(FlatMapMatchesStdMap) {
+    std::cout << "Тест: flat_map на нашем аллокаторе совпадает с std::map" << std::endl;
+    
+    using MapAlloc = allocator<std::pair<const int, int>, 10>;
+    flat_map<int, int, std::less<int>, MapAlloc> flat;
+    std::map<int, int> reference;
+    unsigned state = 4242;
+    for (int i = 0; i < 5000; ++i) {
+        state = state * 1103515245 + 12345;
+        int key = static_cast<int>(state >> 16) % 2000 - 1000;
+        switch (i % 4) {
+            case 0: flat[key] += i; reference[key] += i; break;
+            case 1: BOOST_CHECK_EQUAL(flat.insert({key, i}).second, reference.insert({key, i}).second); break;
+            case 2: BOOST_CHECK_EQUAL(flat.erase(key), reference.erase(key)); break;
+            default: flat.insert_or_assign(key, -i); reference.insert_or_assign(key, -i); break;
+        }
+    }
+    BOOST_CHECK_EQUAL(flat.size(), reference.size());
+    BOOST_CHECK(std::equal(flat.begin(), flat.end(), reference.begin(), reference.end(),
+                           [](const auto& a, const auto& b) { return a.first == b.first && a.second == b.second; }));
+    // Поиск: окна бинарного поиска и линейного прохода, ключи за пределами таблицы
+    for (int key = -1002; key <= 1002; ++key) {
+        auto lower = flat.lower_bound(key);
+        auto upper = flat.upper_bound(key);
+        auto expected_lower = reference.lower_bound(key);
+        auto expected_upper = reference.upper_bound(key);
+        BOOST_CHECK(lower == flat.end() ? expected_lower == reference.end() : lower->first == expected_lower->first);
+        BOOST_CHECK(upper == flat.end() ? expected_upper == reference.end() : upper->first == expected_upper->first);
+        BOOST_CHECK_EQUAL(flat.count(key), reference.count(key));
+    }
+    BOOST_CHECK_THROW(flat.at(5000), std::out_of_range);
+    
+    // Таблица факториалов: тот же заполнитель, что и для std::map
+    detail::custom_flat_map table;
+    detail::fill_custom_flat_map(table);
+    std::map<int, int, std::less<int>, MapAlloc> map_table;
+    detail::fill_custom_map(map_table);
+    BOOST_CHECK(std::equal(table.begin(), table.end(), map_table.begin(), map_table.end(),
+                           [](const auto& a, const auto& b) { return a.first == b.first && a.second == b.second; }));
+    BOOST_CHECK_EQUAL(table.at(9), 362880);
+}
+
+BOOST_AUTO_TEST_CASE(FlatMapBulkConstruction) {
+    std::cout << "Тест: flat_map: построение из диапазона и копирование" << std::endl;
+    
+    // Неупорядоченный диапазон с повторами: остается первая пара с ключом, как у std::map
+    std::vector<std::pair<std::string, int>> unsorted = {{"c", 1}, {"a", 2}, {"b", 3}, {"a", 4}, {"c", 5}};
+    flat_map<std::string, int, std::less<>, allocator<std::pair<const std::string, int>, 16>> words(unsorted.begin(), unsorted.end());
+    BOOST_CHECK_EQUAL(words.size(), 3);
+    BOOST_CHECK_EQUAL(words.begin()->first, "a");
+    BOOST_CHECK_EQUAL(words.at("a"), 2);
+    BOOST_CHECK_EQUAL(words.at("c"), 1);
+    BOOST_CHECK(words.find("z") == words.end());
+    words.insert({{"d", 6}, {"a", 7}});
+    BOOST_CHECK_EQUAL(words.size(), 4);
+    BOOST_CHECK_EQUAL(words.at("a"), 2);
+    
+    std::vector<std::pair<int, int>> sorted;
+    for (int i = 0; i < 1000; ++i) sorted.emplace_back(i * 2, i);
+    using Alloc = allocator<std::pair<const int, int>, 64>;
+    flat_map<int, int, std::less<int>, Alloc> evens(sorted_unique, sorted.begin(), sorted.end());
+    BOOST_CHECK_EQUAL(evens.size(), 1000);
+    BOOST_CHECK_EQUAL(evens.capacity(), 1000);
+    BOOST_CHECK_EQUAL(evens.at(1998), 999);
+    BOOST_CHECK(evens.find(7) == evens.end());
+    
+    // Упорядоченная пачка вливается одним слиянием: нечетные ключи, края и уже имеющиеся ключи
+    flat_map<int, int, std::less<int>, Alloc> merged(evens);
+    std::vector<std::pair<int, int>> odds = {{-3, -1}, {0, -2}};
+    for (int i = 0; i < 1000; ++i) {
+        if (i == 500) odds.emplace_back(1000, -3);
+        odds.emplace_back(i * 2 + 1, -i);
+    }
+    odds.emplace_back(5000, -4);
+    merged.insert(sorted_unique, odds.begin(), odds.end());
+    BOOST_CHECK_EQUAL(merged.size(), 2002);
+    BOOST_CHECK_EQUAL(merged.capacity(), 2002);
+    BOOST_CHECK(std::is_sorted(merged.key_data(), merged.key_data() + merged.size()));
+    BOOST_CHECK_EQUAL(merged.at(-3), -1);
+    BOOST_CHECK_EQUAL(merged.at(0), 0);
+    BOOST_CHECK_EQUAL(merged.at(7), -3);
+    BOOST_CHECK_EQUAL(merged.at(1000), 500);
+    BOOST_CHECK_EQUAL(merged.at(1998), 999);
+    BOOST_CHECK_EQUAL(merged.at(5000), -4);
+    // Ключи-строки: вставка в начало, середину и конец, повтор не заменяет имеющийся
+    using Words = flat_map<std::string, int, std::less<>, allocator<std::pair<const std::string, int>, 16>>;
+    Words letters = {{"b", 1}, {"d", 2}};
+    std::vector<std::pair<std::string, int>> parsed = {{"a", 9}, {"c", 9}, {"d", 9}, {"e", 9}};
+    letters.insert(sorted_unique, parsed.begin(), parsed.end());
+    BOOST_CHECK_EQUAL(letters.size(), 5);
+    BOOST_CHECK_EQUAL(letters.begin()->first, "a");
+    BOOST_CHECK_EQUAL(letters.at("d"), 2);
+    BOOST_CHECK_EQUAL(letters.at("e"), 9);
+    
+    flat_map<int, int, std::less<int>, Alloc> copy(evens);
+    BOOST_CHECK(copy == evens);
+    copy.erase(copy.begin(), copy.begin() + 500);
+    BOOST_CHECK_EQUAL(copy.begin()->first, 1000);
+    BOOST_CHECK(copy != evens);
+    flat_map<int, int, std::less<int>, Alloc> moved(std::move(copy));
+    BOOST_CHECK(copy.empty());
+    BOOST_CHECK_EQUAL(moved.size(), 500);
+    copy = moved;
+    BOOST_CHECK(copy == moved);
+    
+    // Полиморфный аллокатор не передается при присваивании: массивы переносятся поэлементно
+    std::pmr::monotonic_buffer_resource first_resource, second_resource;
+    using PmrMap = flat_map<int, int, std::less<int>, std::pmr::polymorphic_allocator<std::pair<const int, int>>>;
+    PmrMap source(&first_resource);
+    for (int i = 0; i < 100; ++i) source[i] = i;
+    PmrMap target(&second_resource);
+    target = std::move(source);
+    BOOST_CHECK_EQUAL(target.size(), 100);
+    BOOST_CHECK(target.get_allocator().resource() == &second_resource);
+}
+
+BOOST_AUTO_TEST_CASE(FlatMapInsertAliasing) {
+    std::cout << "Тест: flat_map: значение из самого словаря на границе роста" << std::endl;
+    
+    // Строки длиннее буфера короткой строки: висячая ссылка на старый массив видна
+    using StringMap = flat_map<int, std::string, std::less<int>, allocator<std::pair<const int, std::string>, 16>>;
+    auto filled = [] {
+        StringMap map;
+        for (int i = 0; i < 4; ++i) map.try_emplace(i * 2 + 1, std::string(40, static_cast<char>('a' + i)));
+        return map;
+    };
+    
+    // Вставка в конец: массивы переезжают
+    StringMap append = filled();
+    BOOST_CHECK_EQUAL(append.capacity(), 4);
+    append.try_emplace(10, append.at(1));
+    BOOST_CHECK_EQUAL(append.at(10), std::string(40, 'a'));
+    
+    // Вставка в середину: массивы переезжают, хвост сдвигается
+    StringMap middle = filled();
+    middle.try_emplace(4, middle.at(7));
+    BOOST_CHECK_EQUAL(middle.at(4), std::string(40, 'd'));
+    middle.insert_or_assign(0, middle.at(3));
+    BOOST_CHECK_EQUAL(middle.at(0), std::string(40, 'b'));
+    BOOST_CHECK_EQUAL(middle.size(), 6);
+}
+
+BOOST_AUTO_TEST_CASE(FlatMapDefaultWithoutArena) {
+    std::cout << "Тест: flat_map по умолчанию не заводит арену" << std::endl;
+    
+    using Map = flat_map<int, int, std::less<int>, allocator<std::pair<const int, int>, 1 << 20>>;
+    size_t before = heap_probe::news.load();
+    Map map;
+    Map moved(std::move(map));
+    BOOST_CHECK_EQUAL(heap_probe::news.load(), before);
+    BOOST_CHECK(moved.empty());
+    moved[1] = 2;
+    BOOST_CHECK_EQUAL(moved.at(1), 2);
+    
+    // Ключи и значения в одной арене: статистика аллокатора видит оба массива
+    using WideMap = flat_map<int, double, std::less<int>, allocator<std::pair<const int, double>, 64, BasicAllocatorTests::stats_policy>>;
+    WideMap wide;
+    wide.reserve(10);
+    allocator_stats stats = wide.get_allocator().get_stats();
+    BOOST_CHECK_EQUAL(stats.live_bytes, 10 * (sizeof(int) + sizeof(double)));
+    BOOST_CHECK_EQUAL(stats.pool_count, 2);
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -198,6 +1127,450 @@ BOOST_AUTO_TEST_CASE(TestMyContainerInsert) {
     BOOST_CHECK_EQUAL(*it, 200);
 }
 
+BOOST_AUTO_TEST_CASE(TestUnrolledLayout) {
+    std::cout << "Тест: MyContainer с развернутыми узлами" << std::endl;
+    
+    // Для int узел с заголовком умещается в кэш-линию
+    BOOST_CHECK_EQUAL((MyContainer<int, std::allocator<int>, unrolled_layout<>>::elements_per_node), 13);
+    
+    // Случайные вставки сверяются со std::list, маленький узел часто делится
+    MyContainer<int, allocator<int, 16>, unrolled_layout<4>> container;
+    std::list<int> expected;
+    std::srand(7);
+    for (int i = 0; i < 300; ++i) {
+        size_t pos = container.empty() ? 0 : std::rand() % (container.size() + 1);
+        auto it = container.begin();
+        auto ref = expected.begin();
+        for (size_t k = 0; k < pos; ++k, ++it, ++ref) {}
+        if (i % 3 == 0) {
+            container.add(i);
+            expected.push_back(i);
+        } else {
+            auto inserted = container.insert(it, i);
+            BOOST_CHECK_EQUAL(*inserted, i);
+            expected.insert(ref, i);
+        }
+    }
+    BOOST_CHECK_EQUAL(container.size(), expected.size());
+    BOOST_CHECK(std::equal(expected.begin(), expected.end(), container.begin()));
+    
+    // Нетривиальные элементы и вывод
+    MyContainer<std::string, std::allocator<std::string>, unrolled_layout<3>> strings;
+    for (const char* word : {"b", "d", "e", "f"}) strings.add(word);
+    strings.insert(strings.begin(), "a");
+    auto it = strings.begin();
+    ++it; ++it;
+    strings.insert(it, "c");
+    std::ostringstream out;
+    strings.print(out);
+    BOOST_CHECK_EQUAL(out.str(), "a b c d e f \n");
+    strings.clear();
+    BOOST_CHECK(strings.empty());
+    BOOST_CHECK(strings.begin() == strings.end());
+}
+
+// Случайные вставки и удаления по итератору, сверка со std::list
+template <typename Container>
+void check_insert_erase_against_list() {
+    Container container;
+    std::list<int> expected;
+    std::srand(11);
+    for (int i = 0; i < 2000; ++i) {
+        size_t pos = container.empty() ? 0 : std::rand() % (container.size() + (i % 4 == 0 ? 0 : 1));
+        auto it = container.begin();
+        auto ref = expected.begin();
+        for (size_t k = 0; k < pos; ++k, ++it, ++ref) {}
+        if (i % 4 == 0 && !container.empty()) {
+            auto next = container.erase(it);
+            auto ref_next = expected.erase(ref);
+            BOOST_CHECK(ref_next == expected.end() ? next == container.end() : *next == *ref_next);
+        } else {
+            container.insert(it, i);
+            expected.insert(ref, i);
+        }
+    }
+    BOOST_CHECK_EQUAL(container.size(), expected.size());
+    BOOST_CHECK(std::equal(expected.begin(), expected.end(), container.begin()));
+}
+
+BOOST_AUTO_TEST_CASE(TestMyContainerInsertErase) {
+    std::cout << "Тест: MyContainer: вставка и удаление по итератору" << std::endl;
+    
+    check_insert_erase_against_list<MyContainer<int>>();
+    check_insert_erase_against_list<MyContainer<int, allocator<int, 32>>>();
+    check_insert_erase_against_list<MyContainer<int, std::allocator<int>, unrolled_layout<4>>>();
+    
+    // Вставка по одному итератору: список растет без обхода от head
+    MyContainer<int> container;
+    for (int i = 0; i < 5; ++i) container.add(i * 10);
+    auto it = container.begin();
+    ++it; ++it;  // 20
+    for (int i = 0; i < 3; ++i) {
+        it = container.insert(it, 11 + i);
+        ++it;
+    }
+    // Вставка по итератору end(), полученному до добавления
+    auto end = container.end();
+    container.add(99);
+    container.insert(end, 100);
+    
+    std::ostringstream out;
+    container.print(out);
+    BOOST_CHECK_EQUAL(out.str(), "0 10 11 12 13 20 30 40 99 100 \n");
+    
+    // Удаление головы и хвоста
+    container.erase(container.begin());
+    it = container.begin();
+    for (size_t k = 1; k < container.size(); ++k) ++it;
+    BOOST_CHECK(container.erase(it) == container.end());
+    container.add(7);
+    std::ostringstream tail_out;
+    container.print(tail_out);
+    BOOST_CHECK_EQUAL(tail_out.str(), "10 11 12 13 20 30 40 99 7 \n");
+}
+
+// Считает копирования и перемещения
+struct tracked {
+    static int copies;
+    static int moves;
+    std::string text;
+    int number;
+    tracked(std::string text, int number) : text(std::move(text)), number(number) {}
+    tracked(const tracked& other) : text(other.text), number(other.number) { ++copies; }
+    tracked(tracked&& other) noexcept : text(std::move(other.text)), number(other.number) { ++moves; }
+};
+int tracked::copies = 0;
+int tracked::moves = 0;
+
+template <typename Layout>
+void check_move_and_emplace() {
+    using Container = MyContainer<tracked, allocator<tracked, 8>, Layout>;
+    tracked::copies = tracked::moves = 0;
+    
+    // Построение на месте, без копий
+    Container container;
+    for (int i = 0; i < 20; ++i) container.emplace_back("value", i);
+    container.emplace(container.begin(), "first", -1);
+    tracked item("moved", 100);
+    container.add(std::move(item));
+    container.insert(container.end(), tracked("temporary", 101));
+    BOOST_CHECK_EQUAL(tracked::copies, 0);
+    BOOST_CHECK_EQUAL(container.size(), 23);
+    BOOST_CHECK_EQUAL(container.begin()->text, "first");
+    
+    // Копия глубокая и делит арену с оригиналом
+    Container copy(container);
+    BOOST_CHECK_EQUAL(tracked::copies, 23);
+    BOOST_CHECK(copy.get_allocator() == container.get_allocator());
+    copy.begin()->text = "changed";
+    BOOST_CHECK_EQUAL(container.begin()->text, "first");
+    
+    // Копия с другим аллокатором
+    Container separate(container, allocator<tracked, 8>());
+    BOOST_CHECK(separate.get_allocator() != container.get_allocator());
+    BOOST_CHECK_EQUAL(separate.size(), 23);
+    
+    // Перемещение забирает узлы без выделений и копий
+    static_assert(std::is_nothrow_move_constructible<Container>::value, "move must be noexcept");
+    static_assert(std::is_nothrow_move_assignable<Container>::value, "move must be noexcept");
+    size_t live = container.get_allocator().get_stats().live_bytes;
+    int copies = tracked::copies;
+    int moves = tracked::moves;
+    Container moved(std::move(container));
+    BOOST_CHECK(container.empty());
+    BOOST_CHECK_EQUAL(moved.size(), 23);
+    BOOST_CHECK_EQUAL(moved.get_allocator().get_stats().live_bytes, live);
+    
+    separate = std::move(moved);
+    BOOST_CHECK(moved.empty());
+    BOOST_CHECK_EQUAL(separate.size(), 23);
+    BOOST_CHECK_EQUAL(tracked::copies, copies);
+    BOOST_CHECK_EQUAL(tracked::moves, moves);
+    
+    copy = separate;
+    BOOST_CHECK_EQUAL(copy.begin()->text, "first");
+    BOOST_CHECK_EQUAL(copy.size(), 23);
+}
+
+BOOST_AUTO_TEST_CASE(TestMyContainerMoveAndEmplace) {
+    std::cout << "Тест: MyContainer: emplace, перемещение и копирование" << std::endl;
+    
+    check_move_and_emplace<node_layout>();
+    check_move_and_emplace<unrolled_layout<4>>();
+    
+    // polymorphic_allocator не переезжает при перемещении: чужие узлы перемещаются поштучно
+    pool_memory_resource<16> first;
+    pool_memory_resource<16> second;
+    using PmrContainer = MyContainer<std::string, std::pmr::polymorphic_allocator<std::string>>;
+    PmrContainer source(&first);
+    for (int i = 0; i < 5; ++i) source.emplace_back(10, static_cast<char>('a' + i));
+    PmrContainer target(&second);
+    target = std::move(source);
+    BOOST_CHECK(source.empty());
+    BOOST_CHECK_EQUAL(target.size(), 5);
+    BOOST_CHECK_EQUAL(*target.begin(), "aaaaaaaaaa");
+    BOOST_CHECK(target.get_allocator().resource() == &second);
+    BOOST_CHECK_EQUAL(first.get_stats().live_bytes, 0);
+}
+
+// Копирование бросает, когда обратный отсчет доходит до нуля
+struct fragile {
+    static int countdown;
+    int value;
+    fragile(int value) : value(value) {}
+    fragile(const fragile& other) : value(other.value) {
+        if (countdown-- == 0) throw std::runtime_error("copy failed");
+    }
+};
+int fragile::countdown = -1;
+
+template <typename Layout, size_t PerNode>
+void check_bulk_append() {
+    using Container = MyContainer<int, allocator<int, 16, BasicAllocatorTests::stats_policy>, Layout>;
+    std::vector<int> values(200);
+    for (int i = 0; i < 200; ++i) values[i] = i;
+    
+    // Диапазон прямых итераторов: узлы пачками
+    Container container(values.begin(), values.end());
+    BOOST_CHECK_EQUAL(container.size(), 200);
+    int expected = 0;
+    bool ordered = true;
+    for (int value : container) ordered = ordered && value == expected++;
+    BOOST_CHECK(ordered);
+    allocator_stats stats = container.get_allocator().get_stats();
+    BOOST_CHECK_EQUAL(stats.allocations, (200 + PerNode - 1) / PerNode);
+    
+    // Добавление к непустому контейнеру, двунаправленные и входные итераторы
+    std::list<int> more = {200, 201, 202};
+    container.append(more.begin(), more.end());
+    std::istringstream input("203 204");
+    container.append(std::istream_iterator<int>(input), std::istream_iterator<int>());
+    BOOST_CHECK_EQUAL(container.size(), 205);
+    Container copy(container.begin(), container.end(), container.get_allocator());
+    BOOST_CHECK_EQUAL(copy.size(), 205);
+    
+    // Список инициализации и assign
+    std::ostringstream out;
+    Container small = {1, 2, 3};
+    small.print(out);
+    small.assign({4, 5});
+    small.print(out);
+    small.assign(values.begin(), values.begin() + 3);
+    small.print(out);
+    BOOST_CHECK_EQUAL(out.str(), "1 2 3 \n4 5 \n0 1 2 \n");
+    
+    // Исключение посреди диапазона: построенное остается, лишняя память возвращается
+    using FragileContainer = MyContainer<fragile, allocator<fragile, 16, BasicAllocatorTests::stats_policy>, Layout>;
+    std::vector<fragile> sources(values.begin(), values.begin() + 100);
+    FragileContainer fragile_container = {fragile(-1)};
+    fragile::countdown = 70;
+    BOOST_CHECK_THROW(fragile_container.append(sources.begin(), sources.end()), std::runtime_error);
+    fragile::countdown = -1;
+    size_t kept = fragile_container.size();
+    BOOST_CHECK(kept >= 1 && kept <= 71);
+    size_t counted = 0;
+    for (fragile& item : fragile_container) { (void)item; ++counted; }
+    BOOST_CHECK_EQUAL(counted, kept);
+    fragile_container.clear();
+    BOOST_CHECK_EQUAL(fragile_container.get_allocator().get_stats().live_bytes, 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestMyContainerBulkAppend) {
+    std::cout << "Тест: MyContainer: добавление диапазона пачками" << std::endl;
+    
+    // Пачка отдельных ячеек: разные адреса, каждая освобождается сама по себе
+    allocator<long long, 8, BasicAllocatorTests::stats_policy> alloc;
+    long long* batch[20];
+    alloc.allocate_batch(batch, 20);
+    BOOST_CHECK_EQUAL(alloc.get_used(), 20);
+    std::set<long long*> distinct(batch, batch + 20);
+    BOOST_CHECK_EQUAL(distinct.size(), 20);
+    allocator_stats stats = alloc.get_stats();
+    BOOST_CHECK_EQUAL(stats.allocations, 20);
+    BOOST_CHECK_EQUAL(stats.new_blocks, 3);
+    // Новые блоки пакета сразу заняты и не числятся пустыми
+    BOOST_CHECK_EQUAL(alloc.get_empty_block_count(), 0);
+    for (long long* p : batch) alloc.deallocate(p, 1);
+    BOOST_CHECK_EQUAL(alloc.get_used(), 0);
+    // Сверх политики удержания остается только текущий блок
+    size_t max_empty = BasicAllocatorTests::stats_policy::retention::max_empty_blocks + 1;
+    BOOST_CHECK_EQUAL(alloc.get_empty_block_count(), alloc.get_block_count());
+    BOOST_CHECK(alloc.get_empty_block_count() <= max_empty);
+    
+    // Пакет, занимающий несколько новых блоков после частично занятого
+    allocator<int, 16> ints;
+    int* first = ints.allocate(1);
+    int* ints_batch[40];
+    ints.allocate_batch(ints_batch, 40);
+    BOOST_CHECK_EQUAL(ints.get_empty_block_count(), 0);
+    ints.deallocate(first, 1);
+    for (int* p : ints_batch) ints.deallocate(p, 1);
+    BOOST_CHECK_EQUAL(ints.get_empty_block_count(), ints.get_block_count());
+    BOOST_CHECK(ints.get_empty_block_count() <= default_allocator_policy::retention::max_empty_blocks + 1);
+    
+    check_bulk_append<node_layout, 1>();
+    check_bulk_append<unrolled_layout<8>, 8>();
+    
+    // Без allocate_batch узлы выделяются по одному
+    MyContainer<int> plain = {1, 2, 3, 4};
+    BOOST_CHECK_EQUAL(plain.size(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(TestUnrolledInsertAliasing) {
+    std::cout << "Тест: MyContainer с развернутыми узлами: вставка ссылки на свой элемент" << std::endl;
+    
+    // Аргумент ссылается на элемент того же узла, который сдвигается или уходит при разбиении
+    using Strings = MyContainer<std::string, std::allocator<std::string>, unrolled_layout<3>>;
+    for (size_t target = 0; target <= 3; ++target) {
+        for (size_t source = 0; source < 3; ++source) {
+            Strings strings = {"alpha", "beta", "gamma"};
+            std::vector<std::string> expected = {"alpha", "beta", "gamma"};
+            auto pos = strings.begin();
+            for (size_t k = 0; k < target; ++k) ++pos;
+            auto src = strings.begin();
+            for (size_t k = 0; k < source; ++k) ++src;
+            const std::string& value = *src;
+            std::string copy = expected[source];
+            auto inserted = strings.insert(pos, value);
+            expected.insert(expected.begin() + target, copy);
+            BOOST_CHECK_EQUAL(*inserted, copy);
+            BOOST_CHECK(std::equal(expected.begin(), expected.end(), strings.begin()));
+        }
+    }
+    
+    // Вставка в конец после удаления хвостового узла, затем удаление по возвращенным итераторам
+    MyContainer<int, allocator<int, 16>, unrolled_layout<2>> numbers = {0, 1, 2, 3, 4, 5};
+    auto it = numbers.begin();
+    for (int k = 0; k < 3; ++k) ++it;
+    numbers.erase(it);                    // узлы [0 1] [2] [4 5]
+    it = numbers.begin();
+    for (int k = 0; k < 3; ++k) ++it;
+    it = numbers.erase(it);
+    numbers.erase(it);                    // хвостовой узел снят: [0 1] [2]
+    auto last = numbers.insert(numbers.end(), 6);
+    BOOST_CHECK_EQUAL(*last, 6);
+    BOOST_CHECK(numbers.erase(last) == numbers.end());
+    last = numbers.insert(numbers.end(), 7);
+    std::vector<int> expected_numbers = {0, 1, 2, 7};
+    BOOST_CHECK(std::equal(expected_numbers.begin(), expected_numbers.end(), numbers.begin()));
+    BOOST_CHECK_EQUAL(numbers.size(), 4);
+    
+    // Перемещение бросает: при исключении содержимое не меняется, освобождено все лишнее
+    using FragileContainer = MyContainer<fragile, allocator<fragile, 16, BasicAllocatorTests::stats_policy>, unrolled_layout<4>>;
+    for (size_t target = 0; target <= 6; ++target) {
+        FragileContainer container;
+        for (int i = 0; i < 6; ++i) container.emplace_back(i);
+        size_t live = container.get_allocator().get_stats().live_bytes;
+        bool inserted = false;
+        for (int budget = 0; !inserted; ++budget) {
+            auto pos = container.begin();
+            for (size_t k = 0; k < target; ++k) ++pos;
+            fragile::countdown = budget;
+            try {
+                container.emplace(pos, 100);
+                inserted = true;
+            } catch (const std::runtime_error&) {
+                BOOST_CHECK_EQUAL(container.size(), 6);
+                BOOST_CHECK_EQUAL(container.get_allocator().get_stats().live_bytes, live);
+                int expected = 0;
+                for (const fragile& item : container) BOOST_CHECK_EQUAL(item.value, expected++);
+            }
+        }
+        fragile::countdown = -1;
+        std::vector<int> expected;
+        for (int i = 0; i < 6; ++i) expected.push_back(i);
+        expected.insert(expected.begin() + target, 100);
+        BOOST_CHECK(std::equal(expected.begin(), expected.end(), container.begin(),
+                               [](int a, const fragile& b) { return a == b.value; }));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(TestOrderedLayout) {
+    std::cout << "Тест: MyContainer: упорядоченный список с индексом skip-list" << std::endl;
+    
+    using Alloc = allocator<int, 64>;
+    using Ordered = MyContainer<int, Alloc, ordered_layout<>>;
+    Ordered ordered;
+    std::multiset<int> reference;
+    unsigned state = 12345;
+    for (int i = 0; i < 3000; ++i) {
+        state = state * 1103515245 + 12345;
+        int value = static_cast<int>(state >> 16) % 1000;
+        ordered.insert(value);
+        reference.insert(value);
+    }
+    BOOST_CHECK_EQUAL(ordered.size(), reference.size());
+    BOOST_CHECK(std::equal(ordered.begin(), ordered.end(), reference.begin(), reference.end()));
+    BOOST_CHECK(ordered.index_levels() >= 3);
+    // Узлы индекса живут в соседнем подпуле той же арены
+    BOOST_CHECK_EQUAL(ordered.get_allocator().get_pool_count(), 2);
+    
+    for (int key = -1; key <= 1001; ++key) {
+        auto lower = ordered.lower_bound(key);
+        auto upper = ordered.upper_bound(key);
+        auto expected_lower = reference.lower_bound(key);
+        auto expected_upper = reference.upper_bound(key);
+        BOOST_CHECK(lower == ordered.end() ? expected_lower == reference.end() : *lower == *expected_lower);
+        BOOST_CHECK(upper == ordered.end() ? expected_upper == reference.end() : *upper == *expected_upper);
+        BOOST_CHECK_EQUAL(ordered.contains(key), reference.count(key) > 0);
+    }
+    
+    // Удаление через find и через обход, индекс остается согласованным
+    for (int key = 0; key < 1000; key += 3) {
+        auto it = ordered.find(key);
+        while (it != ordered.end() && *it == key) {
+            it = ordered.erase(it);
+        }
+        reference.erase(key);
+    }
+    for (auto it = ordered.begin(); it != ordered.end(); ) {
+        if (*it % 5 == 0) {
+            it = ordered.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = reference.begin(); it != reference.end(); ) {
+        it = *it % 5 == 0 ? reference.erase(it) : std::next(it);
+    }
+    BOOST_CHECK(std::equal(ordered.begin(), ordered.end(), reference.begin(), reference.end()));
+    BOOST_CHECK(!ordered.contains(3));
+    BOOST_CHECK(ordered.find(1) != ordered.end());
+    
+    // Равные элементы стоят в порядке вставки
+    using Pair = std::pair<int, int>;
+    auto by_first = [](const Pair& a, const Pair& b) { return a.first < b.first; };
+    MyContainer<Pair, std::allocator<Pair>, ordered_layout<decltype(by_first)>> stable(by_first);
+    for (int i = 0; i < 50; ++i) stable.insert(Pair(i % 3, i));
+    int last_second = -1;
+    for (auto it = stable.find(Pair(1, 0)); it != stable.end() && it->first == 1; ++it) {
+        BOOST_CHECK(it->second > last_second);
+        last_second = it->second;
+    }
+    
+    // Копия, перемещение, свой порядок
+    Ordered copy(ordered);
+    Ordered moved(std::move(copy));
+    BOOST_CHECK(copy.empty());
+    BOOST_CHECK(std::equal(moved.begin(), moved.end(), ordered.begin(), ordered.end()));
+    moved.insert(-5);
+    BOOST_CHECK_EQUAL(*moved.begin(), -5);
+    copy = moved;
+    BOOST_CHECK_EQUAL(copy.size(), moved.size());
+    MyContainer<int, Alloc, ordered_layout<std::greater<int>>> descending = {3, 1, 2};
+    BOOST_CHECK_EQUAL(*descending.begin(), 3);
+    BOOST_CHECK(descending.lower_bound(2) != descending.end() && *descending.lower_bound(2) == 2);
+    
+    // Все узлы, включая индекс, возвращаются в арену
+    Alloc shared;
+    {
+        Ordered local(shared);
+        for (int i = 0; i < 500; ++i) local.insert(i);
+        BOOST_CHECK(shared.get_stats().live_bytes > 0);
+    }
+    BOOST_CHECK_EQUAL(shared.get_stats().live_bytes, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 // ============================================
 // ДЕМОНСТРАЦИОННЫЙ ТЕСТ (ОСНОВНОЕ ЗАДАНИЕ)
@@ -254,9 +1627,116 @@ BOOST_AUTO_TEST_CASE(AllocatorEquality) {
     allocator<int, 10> alloc1;
     allocator<double, 10> alloc2;
     
-    // Аллокаторы с одинаковым размером считаются равными
-    BOOST_CHECK(alloc1 == alloc2);
-    BOOST_CHECK(!(alloc1 != alloc2));
+    // Независимые аллокаторы владеют разными аренами
+    BOOST_CHECK(alloc1 != alloc2);
+    BOOST_CHECK(!(alloc1 == alloc2));
+    
+    // Копия и rebind-вариант делят арену с исходным аллокатором
+    allocator<int, 10> copy = alloc1;
+    allocator<double, 10> rebound(alloc1);
+    BOOST_CHECK(copy == alloc1);
+    BOOST_CHECK(rebound == alloc1);
+    
+    // Память, выделенная через копию, освобождается через оригинал
+    int* p = copy.allocate(3);
+    BOOST_CHECK_EQUAL(alloc1.get_used(), 3);
+    alloc1.deallocate(p, 3);
+    BOOST_CHECK_EQUAL(copy.get_used(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(SharedArenaInContainers) {
+    std::cout << "Тест: Контейнеры делят одну арену" << std::endl;
+    
+    using MapAlloc = allocator<std::pair<const int, int>, 10>;
+    using Map = std::map<int, int, std::less<int>, MapAlloc>;
+    
+    MapAlloc alloc;
+    Map map1(std::less<int>(), alloc);
+    Map map2(std::less<int>(), alloc);
+    for (int i = 0; i < 10; ++i) {
+        map1[i] = i;
+        map2[i + 100] = i;
+    }
+    
+    // rebind к типу узла не создает лишнего пула под std::pair
+    BOOST_CHECK(map1.get_allocator() == alloc);
+    BOOST_CHECK_EQUAL(alloc.get_pool_count(), 1);
+    
+    // Обмен и перемещение между контейнерами одной арены безопасны
+    std::swap(map1, map2);
+    BOOST_CHECK_EQUAL(map1.begin()->first, 100);
+    Map map3 = std::move(map1);
+    map2.clear();
+    BOOST_CHECK_EQUAL(map3.size(), 10);
+    BOOST_CHECK(map3.get_allocator() == alloc);
+}
+
+BOOST_AUTO_TEST_CASE(LazyArenaCreation) {
+    std::cout << "Тест: Арена создается при первом выделении или копировании" << std::endl;
+    
+    // Аллокатор по умолчанию пуст, запросы состояния ничего не создают
+    using Alloc = allocator<int, 1 << 20>;
+    Alloc fresh;
+    BOOST_CHECK_EQUAL(fresh.get_pool_count(), 0);
+    BOOST_CHECK_EQUAL(fresh.get_capacity(), 0);
+    BOOST_CHECK_EQUAL(fresh.get_stats().init_size, size_t(1) << 20);
+    BOOST_CHECK_EQUAL(fresh.trim(), 0);
+    BOOST_CHECK(fresh == fresh);
+    BOOST_CHECK(fresh != Alloc());
+    
+    // Освобождение через аллокатор без арены — чужой указатель
+    count_errors::reset();
+    int value = 0;
+    fresh.deallocate(&value, 1);
+    BOOST_CHECK_EQUAL(count_errors::count(allocation_error::foreign_pointer), 1);
+    
+    // Копия и rebind делят арену, созданную при копировании
+    Alloc copy(fresh);
+    allocator<double, 1 << 20> rebound(fresh);
+    BOOST_CHECK(copy == fresh);
+    BOOST_CHECK(rebound == fresh);
+    int* p = copy.allocate(2);
+    BOOST_CHECK_EQUAL(fresh.get_used(), 2);
+    fresh.deallocate(p, 2);
+    BOOST_CHECK_EQUAL(copy.get_used(), 0);
+    // Освобождение через rebind без своего подпула — чужой указатель, подпул не создается
+    count_errors::reset();
+    double stray = 0;
+    rebound.deallocate(&stray, 1);
+    BOOST_CHECK_EQUAL(count_errors::count(allocation_error::foreign_pointer), 1);
+    BOOST_CHECK_EQUAL(fresh.get_pool_count(), 1);
+    Alloc assigned;
+    Alloc source;
+    assigned = source;
+    BOOST_CHECK(assigned == source);
+    
+    // Пустые контейнеры не трогают арену, перемещение сохраняет общую арену
+    std::map<int, int, std::less<int>, allocator<std::pair<const int, int>, 1 << 20>> map;
+    MyContainer<int, Alloc> container;
+    BOOST_CHECK(map.empty() && container.empty());
+    std::deque<int, allocator<int, 64>> queue;
+    for (int i = 0; i < 100; ++i) queue.push_back(i);
+    std::deque<int, allocator<int, 64>> moved(std::move(queue));
+    BOOST_CHECK_EQUAL(moved.back(), 99);
+    queue.push_back(1);
+    BOOST_CHECK_EQUAL(queue.size(), 1);
+    
+    // Перемещение аллокатора и контейнеров на нем не создает арену и не бросает
+    static_assert(std::is_nothrow_move_constructible<Alloc>::value, "allocator move must not throw");
+    static_assert(std::is_nothrow_move_assignable<Alloc>::value, "allocator move must not throw");
+    size_t before = heap_probe::news.load();
+    Alloc empty;
+    Alloc taken(std::move(empty));
+    allocator<double, 1 << 20> rebound_taken(std::move(taken));
+    MyContainer<int, Alloc> moved_container(std::move(container));
+    BOOST_CHECK_EQUAL(heap_probe::news.load(), before);
+    BOOST_CHECK_EQUAL(taken.get_pool_count(), 0);
+    BOOST_CHECK_EQUAL(rebound_taken.get_pool_count(), 0);
+    
+    // Перемещенный аллокатор с ареной делит ее с источником
+    Alloc shared(std::move(copy));
+    BOOST_CHECK(shared == copy);
+    BOOST_CHECK(shared == fresh);
 }
 
 BOOST_AUTO_TEST_CASE(StringAllocation) {
@@ -276,4 +1756,307 @@ BOOST_AUTO_TEST_CASE(StringAllocation) {
     
     alloc.destroy(s1);
     alloc.destroy(s2);
-}
\ No newline at end of file
+}
+
+// ============================================
+// ТЕСТЫ ПОТОКОБЕЗОПАСНОГО АЛЛОКАТОРА
+// ============================================
+
+BOOST_AUTO_TEST_SUITE(ConcurrentAllocatorTests)
+
+BOOST_AUTO_TEST_CASE(ProducersAndConsumers) {
+    std::cout << "Тест: Выделение в одних потоках, освобождение в других" << std::endl;
+    
+    using Alloc = concurrent_allocator<long long, 128>;
+    const int producers = 4;
+    const int per_producer = 50000;
+    
+    std::mutex mutex;
+    std::deque<long long*> queue;
+    std::atomic<int> produced_done(0);
+    std::atomic<long long> consumed_sum(0);
+    std::atomic<int> consumed(0);
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < producers; ++t) {
+        threads.emplace_back([&, t] {
+            Alloc alloc;
+            for (int i = 0; i < per_producer; ++i) {
+                long long* p = alloc.allocate(1);
+                alloc.construct(p, static_cast<long long>(t) * per_producer + i);
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push_back(p);
+            }
+            ++produced_done;
+        });
+    }
+    for (int t = 0; t < producers; ++t) {
+        threads.emplace_back([&] {
+            Alloc alloc;
+            while (true) {
+                long long* p = nullptr;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!queue.empty()) {
+                        p = queue.front();
+                        queue.pop_front();
+                    } else if (produced_done == producers) {
+                        break;
+                    }
+                }
+                if (!p) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                consumed_sum += *p;
+                ++consumed;
+                alloc.destroy(p);
+                alloc.deallocate(p, 1);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    
+    const long long total = static_cast<long long>(producers) * per_producer;
+    BOOST_CHECK_EQUAL(consumed.load(), total);
+    BOOST_CHECK_EQUAL(consumed_sum.load(), total * (total - 1) / 2);
+}
+
+BOOST_AUTO_TEST_CASE(MapsInParallel) {
+    std::cout << "Тест: std::map в нескольких потоках одновременно" << std::endl;
+    
+    using Map = std::map<int, int, std::less<int>, concurrent_allocator<std::pair<const int, int>>>;
+    const int thread_count = 4;
+    std::vector<Map> maps(thread_count);
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&maps, t] {
+            for (int i = 0; i < 20000; ++i) {
+                maps[t][i] = i * t;
+            }
+            // Половина узлов освобождается сразу, остальные — в главном потоке
+            for (int i = 0; i < 20000; i += 2) {
+                maps[t].erase(i);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    
+    for (int t = 0; t < thread_count; ++t) {
+        BOOST_CHECK_EQUAL(maps[t].size(), 10000);
+        BOOST_CHECK_EQUAL(maps[t][9999], 9999 * t);
+    }
+    maps.clear();
+}
+
+BOOST_AUTO_TEST_CASE(LockFreePoolGrowthFailure) {
+    std::cout << "Тест: Lock-free пул: нехватка памяти при росте не занимает номер блока" << std::endl;
+    
+    using Pool = detail::lockfree_pool<16, 16, 8, 2>;
+    Pool pool;
+    heap_probe::fail_aligned = true;
+    BOOST_CHECK_THROW(pool.allocate(), std::bad_alloc);
+    heap_probe::fail_aligned = false;
+    BOOST_CHECK_EQUAL(pool.get_block_count(), 0);
+    
+    // Оба места под блоки по-прежнему доступны
+    for (size_t i = 0; i < 2 * Pool::slots_per_block; ++i) {
+        BOOST_CHECK(pool.allocate() != nullptr);
+    }
+    BOOST_CHECK_EQUAL(pool.get_block_count(), 2);
+    BOOST_CHECK_THROW(pool.allocate(), std::bad_alloc);
+}
+
+BOOST_AUTO_TEST_CASE(LockFreePoolContention) {
+    std::cout << "Тест: Lock-free пул под конкуренцией потоков" << std::endl;
+    
+    using Alloc = lockfree_allocator<long long, 64>;
+    const int thread_count = 4;
+    const int iterations = 50000;
+    
+    // Потоки обмениваются узлами через общие ячейки: узел освобождает не тот, кто выделил
+    std::atomic<long long*> exchange[16];
+    for (auto& e : exchange) e.store(nullptr);
+    std::atomic<long long> bad_values(0);
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            Alloc alloc;
+            for (int i = 0; i < iterations; ++i) {
+                long long* p = alloc.allocate(1);
+                *p = t + 1;
+                long long* old = exchange[(i * 7 + t) % 16].exchange(p);
+                if (old) {
+                    if (*old < 1 || *old > thread_count) ++bad_values;
+                    alloc.deallocate(old, 1);
+                }
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    
+    Alloc alloc;
+    for (auto& e : exchange) {
+        if (long long* p = e.exchange(nullptr)) alloc.deallocate(p, 1);
+    }
+    BOOST_CHECK_EQUAL(bad_values.load(), 0);
+    
+    // Ячейки переиспользуются: блоков заметно меньше, чем выделений
+    BOOST_CHECK(Alloc::get_block_count() < 10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// ============================================
+// ТЕСТЫ ПАРАЛЛЕЛЬНЫХ АЛГОРИТМОВ
+// ============================================
+
+BOOST_AUTO_TEST_SUITE(ParallelAlgorithmTests)
+
+template <typename Layout>
+void check_parallel_matches_serial(thread_pool& pool) {
+    using Container = MyContainer<long long, allocator<long long, 64>, Layout>;
+    std::vector<long long> values(10007);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<long long>(i % 101);
+    Container container(values.begin(), values.end());
+    
+    // Границы покрывают контейнер ровно один раз и по порядку
+    std::vector<typename Container::iterator> bounds = container.split_points(7);
+    BOOST_CHECK(bounds.front() == container.begin());
+    BOOST_CHECK(bounds.back() == container.end());
+    size_t covered = 0;
+    for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+        for (auto it = bounds[i]; it != bounds[i + 1]; ++it) ++covered;
+    }
+    BOOST_CHECK_EQUAL(covered, values.size());
+    
+    long long serial = 0;
+    for (long long value : container) serial += value * value;
+    long long sum = parallel::transform_reduce(pool, container, 0LL, std::plus<long long>(),
+                                               [](long long value) { return value * value; });
+    BOOST_CHECK_EQUAL(sum, serial);
+    
+    // Некоммутативная свертка: порядок диапазонов сохраняется
+    Container digits = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::string joined = parallel::transform_reduce(pool, digits, std::string(">"),
+        [](std::string left, const std::string& right) { return left + right; },
+        [](long long value) { return std::to_string(value); });
+    BOOST_CHECK_EQUAL(joined, ">123456789");
+    
+    // Готовое разбиение переиспользуется без нового прохода
+    parallel::for_each(pool, bounds, [](long long& value) { value += 1; });
+    BOOST_CHECK_EQUAL(*container.begin(), 1);
+    long long shifted = parallel::transform_reduce(pool, bounds, 0LL, std::plus<long long>(),
+                                                   [](long long value) { return value; });
+    BOOST_CHECK_EQUAL(shifted, std::accumulate(values.begin(), values.end(), 0LL) + static_cast<long long>(values.size()));
+    
+    // Первое по порядку совпадение, как у последовательного поиска
+    auto serial_hit = container.begin();
+    while (serial_hit != container.end() && *serial_hit != 50) ++serial_hit;
+    auto hit = parallel::find_if(pool, container, [](long long value) { return value == 50; });
+    BOOST_CHECK(hit == serial_hit);
+    auto miss = parallel::find_if(pool, container, [](long long value) { return value < 0; });
+    BOOST_CHECK(miss == container.end());
+    
+    Container empty;
+    BOOST_CHECK_EQUAL(parallel::transform_reduce(pool, empty, 5LL, std::plus<long long>(),
+                                                 [](long long value) { return value; }), 5);
+    BOOST_CHECK(parallel::find_if(pool, empty, [](long long) { return true; }) == empty.end());
+}
+
+BOOST_AUTO_TEST_CASE(SegmentedAlgorithmsMatchSerial) {
+    std::cout << "Тест: Параллельные алгоритмы совпадают с последовательными" << std::endl;
+    
+    thread_pool pool(3);
+    BOOST_CHECK_EQUAL(pool.concurrency(), 4);
+    check_parallel_matches_serial<node_layout>(pool);
+    check_parallel_matches_serial<unrolled_layout<16>>(pool);
+    
+    // Исключение из задачи доходит до вызывающего, пул остается рабочим
+    std::atomic<int> calls(0);
+    BOOST_CHECK_THROW(pool.run(32, [&](size_t i) {
+        ++calls;
+        if (i == 5) throw std::runtime_error("task failed");
+    }), std::runtime_error);
+    BOOST_CHECK_EQUAL(calls.load(), 32);
+    pool.run(8, [&](size_t) { ++calls; });
+    BOOST_CHECK_EQUAL(calls.load(), 40);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// ============================================
+// ТЕСТЫ РЕСУРСА ПАМЯТИ STD::PMR
+// ============================================
+
+BOOST_AUTO_TEST_SUITE(PmrResourceTests)
+
+BOOST_AUTO_TEST_CASE(PmrContainersOnPool) {
+    std::cout << "Тест: std::pmr контейнеры на пуле блоков" << std::endl;
+    
+    pool_memory_resource<16> resource;
+    {
+        std::pmr::map<int, int> map(&resource);
+        std::pmr::vector<long long> vec(&resource);
+        std::pmr::list<char> list(&resource);
+        for (int i = 0; i < 100; ++i) {
+            map[i] = i * i;
+            vec.push_back(i);
+            list.push_back(static_cast<char>('a' + i % 26));
+        }
+        BOOST_CHECK_EQUAL(map[9], 81);
+        BOOST_CHECK_EQUAL(vec[99], 99);
+        BOOST_CHECK_EQUAL(list.size(), 100);
+        
+        // Узлы map, узлы list и буферы vector — разные классы размера одного ресурса
+        BOOST_CHECK(resource.get_pool_count() >= 3);
+        BOOST_CHECK(resource.get_stats().live_bytes > 0);
+    }
+    BOOST_CHECK_EQUAL(resource.get_stats().live_bytes, 0);
+}
+
+BOOST_AUTO_TEST_CASE(PmrUpstreamAndEquality) {
+    std::cout << "Тест: Крупные запросы и сравнение ресурсов" << std::endl;
+    
+    pool_memory_resource<16> resource(std::pmr::new_delete_resource());
+    BOOST_CHECK(resource.upstream_resource() == std::pmr::new_delete_resource());
+    
+    // Крупный буфер идет мимо пула
+    void* big = resource.allocate(4096);
+    BOOST_CHECK_EQUAL(resource.get_pool_count(), 0);
+    resource.deallocate(big, 4096);
+    
+    // Размеры одного класса обслуживает один подпул
+    void* a = resource.allocate(20);
+    void* b = resource.allocate(30);
+    BOOST_CHECK_EQUAL(resource.get_pool_count(), 1);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(a) % alignof(std::max_align_t), 0);
+    resource.deallocate(a, 20);
+    resource.deallocate(b, 30);
+    
+    pool_memory_resource<16> other;
+    BOOST_CHECK(resource == resource);
+    BOOST_CHECK(!resource.is_equal(other));
+}
+
+BOOST_AUTO_TEST_CASE(MyContainerWithPolymorphicAllocator) {
+    std::cout << "Тест: MyContainer с polymorphic_allocator" << std::endl;
+    
+    pool_memory_resource<16> resource;
+    {
+        MyContainer<int, std::pmr::polymorphic_allocator<int>> container(&resource);
+        for (int i = 0; i < 10; ++i) {
+            container.add(i);
+        }
+        container.insert(container.begin(), -1);
+        BOOST_CHECK_EQUAL(container.size(), 11);
+        BOOST_CHECK_EQUAL(*container.begin(), -1);
+        BOOST_CHECK(container.get_allocator().resource() == &resource);
+        BOOST_CHECK_EQUAL(resource.get_stats().block_count, 1);
+    }
+    BOOST_CHECK_EQUAL(resource.get_stats().live_bytes, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()